@@ -0,0 +1,28 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+// Per thread, so a frame is only charged for what the frame thread did, not for work that
+// happened to land on another thread meanwhile
+static thread_local size_t allocations = 0;
+
+// Replacing the plain forms is enough: the array forms forward to them, and the over-aligned
+// forms keep their default pairing of allocation and release
+void* operator new(size_t size) {
+	++allocations;
+	if (void* memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+size_t AllocationCounter::count() {
+	return allocations;
+}
+#else
+size_t AllocationCounter::count() {
+	return 0;
+}
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+// Counts global heap allocations per thread, so Game can check that steady-state frames don't
+// make any. Debug builds only: with NDEBUG defined operator new is left alone and count() is always 0.
+namespace AllocationCounter {
+    // operator new calls made by the calling thread since it started
+    size_t count();
+}
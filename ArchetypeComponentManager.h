@@ -0,0 +1,557 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Entity.h"
+#include "Components.h"
+#include "ComponentFamily.h"
+#include "JobScheduler.h"
+
+constexpr size_t MaxComponentTypes = 64;
+using Signature = std::bitset<MaxComponentTypes>;  // Bit N set if the archetype has component family N
+using ComponentSizes = std::array<size_t, MaxComponentTypes>;  // sizeof each component, by family
+
+// All entities that have exactly the same set of components.
+// Rows are packed across fixed-size chunks, and each chunk holds one contiguous array per
+// component type (plus the entity IDs), so a query sweeps every column linearly.
+class Archetype {
+public:
+    static constexpr size_t ChunkBytes = 16 * 1024;
+    static constexpr size_t ColumnAlignment = 64;  // Keep every column on its own cache line
+
+    Archetype(const Signature& signature, const ComponentSizes& componentSizes)
+        : signature(signature), rows(0) {
+        columnOf.fill(npos);
+
+        size_t rowBytes = sizeof(Entity::ID);
+        for (size_t family = 0; family < MaxComponentTypes; ++family) {
+            if (signature.test(family)) {
+                columnOf[family] = static_cast<unsigned int>(columns.size());
+                columns.push_back({ static_cast<ComponentFamily::ID>(family), componentSizes[family], 0 });
+                rowBytes += componentSizes[family];
+            }
+        }
+
+        // Largest power of two that fits, so row -> (chunk, slot) is a shift and a mask
+        capacityShift = 0;
+        while ((size_t(2) << capacityShift) * rowBytes <= ChunkBytes) {
+            ++capacityShift;
+        }
+        capacity = size_t(1) << capacityShift;
+
+        // Entity IDs first, then one aligned array per component
+        size_t offset = alignUp(capacity * sizeof(Entity::ID));
+        for (Column& column : columns) {
+            column.offset = offset;
+            offset = alignUp(offset + capacity * column.size);
+        }
+        chunkBytes = offset;
+
+        addEdges.fill(nullptr);
+        removeEdges.fill(nullptr);
+    }
+
+    // Append a row for the entity and return its index; component data is left for the caller to fill
+    unsigned int allocateRow(Entity::ID entity) {
+        if (rows == chunks.size() * capacity) {
+            chunks.emplace_back(static_cast<std::byte*>(::operator new(chunkBytes, std::align_val_t{ ColumnAlignment })));
+        }
+
+        unsigned int row = static_cast<unsigned int>(rows++);
+        entityAt(row) = entity;
+        return row;
+    }
+
+    // Remove a row by moving the last row into it. Returns the entity that moved, or
+    // Entity::Invalid if the removed row was already the last one.
+    Entity::ID removeRow(unsigned int row) {
+        unsigned int last = static_cast<unsigned int>(rows - 1);
+        Entity::ID moved = Entity::Invalid;
+
+        if (row != last) {
+            moved = entityAt(last);
+            entityAt(row) = moved;
+            for (const Column& column : columns) {
+                std::memcpy(data(column, row), data(column, last), column.size);
+            }
+        }
+
+        --rows;
+        if (rows + capacity <= (chunks.size() - 1) * capacity) {
+            chunks.pop_back();  // Keep one spare chunk so add/remove churn at a boundary doesn't reallocate
+        }
+        return moved;
+    }
+
+    bool has(ComponentFamily::ID family) const { return columnOf[family] != npos; }
+
+    // Raw storage for a component of the given family at a row, or nullptr if this archetype lacks it
+    void* component(ComponentFamily::ID family, unsigned int row) {
+        unsigned int column = columnOf[family];
+        return (column != npos) ? data(columns[column], row) : nullptr;
+    }
+
+    // Base of one component's packed array inside a chunk, for linear sweeps
+    template <typename T>
+    T* columnArray(size_t chunk) {
+        return reinterpret_cast<T*>(chunks[chunk].get() + columns[columnOf[ComponentFamily::id<T>()]].offset);
+    }
+
+    const Entity::ID* entityArray(size_t chunk) const {
+        return reinterpret_cast<const Entity::ID*>(chunks[chunk].get());
+    }
+
+    Entity::ID entity(unsigned int row) {
+        return entityAt(row);
+    }
+
+    size_t size() const { return rows; }
+    size_t chunkCount() const { return (rows + capacity - 1) >> capacityShift; }
+    size_t rowsInChunk(size_t chunk) const { return std::min(capacity, rows - chunk * capacity); }
+
+    const Signature signature;
+    std::array<Archetype*, MaxComponentTypes> addEdges;  // Cached transition when a component is added
+    std::array<Archetype*, MaxComponentTypes> removeEdges;  // Cached transition when a component is removed
+
+private:
+    struct Column {
+        ComponentFamily::ID family;
+        size_t size;
+        size_t offset;  // Byte offset of this component's array within a chunk
+    };
+
+    // Chunks come from aligned new, so column offsets rounded to ColumnAlignment land on cache lines
+    struct ChunkDeleter {
+        void operator()(std::byte* chunk) const {
+            ::operator delete(chunk, std::align_val_t{ ColumnAlignment });
+        }
+    };
+
+    static constexpr unsigned int npos = ~0u;
+
+    static size_t alignUp(size_t value) {
+        return (value + ColumnAlignment - 1) & ~(ColumnAlignment - 1);
+    }
+
+    std::byte* data(const Column& column, unsigned int row) {
+        return chunks[row >> capacityShift].get() + column.offset + (row & (capacity - 1)) * column.size;
+    }
+
+    Entity::ID& entityAt(unsigned int row) {
+        return reinterpret_cast<Entity::ID*>(chunks[row >> capacityShift].get())[row & (capacity - 1)];
+    }
+
+    std::vector<Column> columns;
+    std::array<unsigned int, MaxComponentTypes> columnOf;  // Component family -> column index
+    std::vector<std::unique_ptr<std::byte, ChunkDeleter>> chunks;
+    size_t rows;
+    size_t capacity;  // Rows per chunk
+    size_t capacityShift;
+    size_t chunkBytes;
+};
+
+// Type-erased base so the manager can tell every view about newly created archetypes
+class IArchetypeView {
+public:
+    virtual ~IArchetypeView() = default;
+    virtual void onArchetypeCreated(Archetype* archetype) = 0;
+};
+
+// Persistent query over every archetype that contains all of Ts.
+// Mirrors View<Ts...>: iteration yields (entity, Ts*...) and each() calls func(entity, Ts&...),
+// but here each() walks every matching chunk's component arrays in a straight line.
+template <typename... Ts>
+class ArchetypeView : public IArchetypeView {
+public:
+    using value_type = std::tuple<Entity::ID, Ts*...>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ArchetypeView::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator(const ArchetypeView* view, size_t match, unsigned int row) : view(view), match(match), row(row) {
+            skipEmpty();
+        }
+
+        value_type operator*() const {
+            Archetype* archetype = view->matches[match];
+            return value_type(archetype->entity(row),
+                static_cast<Ts*>(archetype->component(ComponentFamily::id<Ts>(), row))...);
+        }
+
+        iterator& operator++() {
+            ++row;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return match == other.match && row == other.row; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void skipEmpty() {
+            while (match < view->matches.size() && row >= view->matches[match]->size()) {
+                ++match;
+                row = 0;
+            }
+        }
+
+        const ArchetypeView* view;
+        size_t match;
+        unsigned int row;
+    };
+
+    explicit ArchetypeView(const std::vector<std::unique_ptr<Archetype>>& archetypes) {
+        for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+            onArchetypeCreated(archetype.get());
+        }
+    }
+
+    void onArchetypeCreated(Archetype* archetype) override {
+        if ((archetype->has(ComponentFamily::id<Ts>()) && ...)) {
+            matches.push_back(archetype);
+        }
+    }
+
+    // Call func(entity, Ts&...) for every member, one chunk's packed arrays at a time
+    template <typename Func>
+    void each(Func func) {
+        for (Archetype* archetype : matches) {
+            for (size_t chunk = 0; chunk < archetype->chunkCount(); ++chunk) {
+                const Entity::ID* entities = archetype->entityArray(chunk);
+                std::tuple<Ts*...> arrays(archetype->template columnArray<Ts>(chunk)...);
+                size_t count = archetype->rowsInChunk(chunk);
+                for (size_t i = 0; i < count; ++i) {
+                    func(entities[i], std::get<Ts*>(arrays)[i]...);
+                }
+            }
+        }
+    }
+
+    // Chunks across every matching archetype, numbered in each() order
+    size_t chunkCount() const {
+        size_t total = 0;
+        for (Archetype* archetype : matches) {
+            total += archetype->chunkCount();
+        }
+        return total;
+    }
+
+    // each() over one chunk only, so separate threads can take separate chunks
+    template <typename Func>
+    void eachInChunk(size_t index, Func func) {
+        auto [archetype, chunk] = chunkAt(index);
+        const Entity::ID* entities = archetype->entityArray(chunk);
+        std::tuple<Ts*...> arrays(archetype->template columnArray<Ts>(chunk)...);
+        size_t count = archetype->rowsInChunk(chunk);
+        for (size_t i = 0; i < count; ++i) {
+            func(entities[i], std::get<Ts*>(arrays)[i]...);
+        }
+    }
+
+    // The archetype and chunk within it of chunk index, numbered as in chunkCount()
+    std::pair<Archetype*, size_t> chunkAt(size_t index) const {
+        for (Archetype* archetype : matches) {
+            if (index < archetype->chunkCount()) {
+                return { archetype, index };
+            }
+            index -= archetype->chunkCount();
+        }
+        assert(false && "Chunk index out of range");
+        return { nullptr, 0 };
+    }
+
+    iterator begin() const { return iterator(this, 0, 0); }
+    iterator end() const { return iterator(this, matches.size(), 0); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (Archetype* archetype : matches) {
+            total += archetype->size();
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    std::vector<Archetype*> matches;
+};
+
+// Component manager backed by archetype chunks instead of one sparse set per component type.
+// Exposes the same interface as the sparse-set ComponentManager; select it by defining
+// CENTRAL_DEFENCE_ARCHETYPE_STORAGE. Adding or removing a component moves the entity's row to
+// another archetype, so it costs more than in the sparse-set backend, while sweeps over
+// entities sharing a signature are linear in memory.
+// Components must be trivially copyable because rows are moved with memcpy.
+class ArchetypeComponentManager {
+public:
+    template <typename T>
+    void addComponent(Entity::ID entity, T component) {
+        static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
+        static_assert(std::is_trivially_copyable<T>::value, "Archetype storage moves components with memcpy");
+
+        ComponentFamily::ID family = registerComponent<T>();
+        Record& record = getRecord(entity);
+        if (record.archetype && record.entity != entity) {
+            destroyEntity(record.entity);  // The slot was recycled without clearing its old generation
+        }
+        record.entity = entity;
+        setEntityInUse(entity, true);
+
+        if (record.archetype && record.archetype->has(family)) {  // Already present, overwrite in place
+            *static_cast<T*>(record.archetype->component(family, record.row)) = std::move(component);
+            return;
+        }
+
+        Archetype* target = record.archetype ? record.archetype->addEdges[family] : nullptr;
+        if (!target) {
+            Signature signature = record.archetype ? record.archetype->signature : Signature();
+            target = findOrCreateArchetype(signature.set(family));
+            if (record.archetype) {
+                record.archetype->addEdges[family] = target;
+            }
+        }
+
+        unsigned int row = moveEntity(entity, target);
+        new (target->component(family, row)) T(std::move(component));
+    }
+
+    template <typename T>
+    void removeComponent(Entity::ID entity) {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        Record* found = findRecord(entity);
+        if (!found) return;
+
+        Record& record = *found;
+        if (!record.archetype->has(family)) return;
+
+        Archetype* target = record.archetype->removeEdges[family];
+        if (!target) {
+            Signature signature = record.archetype->signature;
+            signature.reset(family);
+            target = signature.any() ? findOrCreateArchetype(signature) : nullptr;
+            record.archetype->removeEdges[family] = target;
+        }
+
+        if (target) {
+            moveEntity(entity, target);
+        }
+        else {
+            detach(entity);  // No components left
+        }
+    }
+
+    // Remove every component of the entity and mark it unused, so its slot can be recycled
+    void destroyEntity(Entity::ID entity) {
+        if (findRecord(entity)) {
+            detach(entity);
+        }
+        setEntityInUse(entity, false);
+    }
+
+    template <typename T>
+    T* getComponent(Entity::ID entity) {
+        const Record* record = findRecord(entity);
+        return record ? static_cast<T*>(record->archetype->component(ComponentFamily::id<T>(), record->row)) : nullptr;
+    }
+
+    template <typename... Ts>
+    ArchetypeView<Ts...>& view() {
+        ViewFamily::ID family = ViewFamily::id<ArchetypeView<Ts...>>();
+        if (family >= views.size()) {
+            views.resize(family + 1);
+        }
+
+        std::unique_ptr<IArchetypeView>& view = views[family];
+        if (!view) {
+            assert(!systemsRunning && "View built while systems run in parallel; build it before the first tick");
+            view = std::make_unique<ArchetypeView<Ts...>>(archetypes);
+        }
+        return *static_cast<ArchetypeView<Ts...>*>(view.get());
+    }
+
+    // Call func(entity, T&, Others&...) for every entity that has all the given components
+    template <typename T, typename... Others, typename Func>
+    void forEach(Func func) {
+        view<T, Others...>().each(func);
+    }
+
+    // forEach with the view's chunks shared out across scheduler's threads. func runs
+    // concurrently, so it may only write the components it is given. It may also read other
+    // components and isEntityInUse, provided nothing running alongside writes them; no call may
+    // add or remove components. Views under ParallelMinimum entities run serially.
+    template <typename T, typename... Others, typename Func>
+    void parallelForEach(JobScheduler& scheduler, Func func) {
+        ArchetypeView<T, Others...>& members = view<T, Others...>();
+        if (members.size() < ParallelMinimum) {
+            members.each(func);
+            return;
+        }
+        scheduler.parallelFor(members.chunkCount(), 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                members.eachInChunk(chunk, func);
+            }
+        });
+    }
+
+    // Call func(archetype, chunk) for every chunk holding entities with all the given components,
+    // for batch kernels that take whole columns (archetype.columnArray<T>(chunk)) at once.
+    // Every row of a chunk belongs to a live entity.
+    template <typename T, typename... Others, typename Func>
+    void forEachChunk(Func func) {
+        ArchetypeView<T, Others...>& members = view<T, Others...>();
+        for (size_t index = 0; index < members.chunkCount(); ++index) {
+            auto [archetype, chunk] = members.chunkAt(index);
+            func(*archetype, chunk);
+        }
+    }
+
+    // forEachChunk with the chunks shared out across scheduler's threads, under the same rules
+    // as parallelForEach
+    template <typename T, typename... Others, typename Func>
+    void parallelForEachChunk(JobScheduler& scheduler, Func func) {
+        ArchetypeView<T, Others...>& members = view<T, Others...>();
+        if (members.size() < ParallelMinimum) {
+            forEachChunk<T, Others...>(func);
+            return;
+        }
+        scheduler.parallelFor(members.chunkCount(), 1, [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+                auto [archetype, chunk] = members.chunkAt(index);
+                func(*archetype, chunk);
+            }
+        });
+    }
+
+    static constexpr size_t ParallelMinimum = 4096;  // Below this a split costs more than it saves
+
+    bool isEntityInUse(Entity::ID entity) const {
+        Entity::ID slot = Entity::indexOf(entity);
+        return slot < inUse.size() && inUse[slot] == entity;
+    }
+
+    void setEntityInUse(Entity::ID entity, bool use) {
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= inUse.size()) {
+            inUse.resize(slot + 1, Entity::Invalid);
+        }
+        if (use) {
+            inUse[slot] = entity;
+        }
+        else if (inUse[slot] == entity) {  // A stale ID can't deactivate the slot's new occupant
+            inUse[slot] = Entity::Invalid;
+        }
+    }
+
+    // Set while a SystemGraph may be running systems side by side. Building a view or group then
+    // asserts, since two systems could race to build the same one; build them all beforehand.
+    void setSystemsRunning(bool running) { systemsRunning = running; }
+
+    size_t archetypeCount() const { return archetypes.size(); }
+
+private:
+    struct Record {
+        Archetype* archetype = nullptr;  // nullptr while the entity has no components
+        unsigned int row = 0;
+        Entity::ID entity = Entity::Invalid;  // Generation that owns the row
+    };
+
+    std::vector<Record> records;  // Indexed by entity index
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<Signature, Archetype*> archetypeIndex;  // Only consulted when an edge isn't cached yet
+    ComponentSizes componentSizes{};  // Indexed by ComponentFamily ID
+    std::vector<std::unique_ptr<IArchetypeView>> views;  // Indexed by ViewFamily ID
+    std::vector<Entity::ID> inUse;  // Indexed by entity index, the active ID in that slot or Entity::Invalid
+    bool systemsRunning = false;
+
+    template <typename T>
+    ComponentFamily::ID registerComponent() {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        assert(family < MaxComponentTypes && "Raise MaxComponentTypes");
+        componentSizes[family] = sizeof(T);
+        return family;
+    }
+
+    Record& getRecord(Entity::ID entity) {
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= records.size()) {
+            records.resize(slot + 1);
+        }
+        return records[slot];
+    }
+
+    // The entity's record if it has components, nullptr for stale IDs
+    Record* findRecord(Entity::ID entity) {
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= records.size()) return nullptr;
+
+        Record& record = records[slot];
+        return (record.archetype && record.entity == entity) ? &record : nullptr;
+    }
+
+    Archetype* findOrCreateArchetype(const Signature& signature) {
+        auto it = archetypeIndex.find(signature);
+        if (it != archetypeIndex.end()) {
+            return it->second;
+        }
+
+        archetypes.push_back(std::make_unique<Archetype>(signature, componentSizes));
+        Archetype* archetype = archetypes.back().get();
+        archetypeIndex[signature] = archetype;
+
+        for (std::unique_ptr<IArchetypeView>& view : views) {
+            if (view) {
+                view->onArchetypeCreated(archetype);
+            }
+        }
+        return archetype;
+    }
+
+    // Move an entity's row into another archetype, copying the components both share
+    unsigned int moveEntity(Entity::ID entity, Archetype* target) {
+        Record& record = records[Entity::indexOf(entity)];
+        unsigned int row = target->allocateRow(entity);
+
+        if (record.archetype) {
+            for (size_t family = 0; family < MaxComponentTypes; ++family) {
+                if (target->signature.test(family) && record.archetype->has(static_cast<ComponentFamily::ID>(family))) {
+                    std::memcpy(target->component(static_cast<ComponentFamily::ID>(family), row),
+                        record.archetype->component(static_cast<ComponentFamily::ID>(family), record.row),
+                        componentSizes[family]);
+                }
+            }
+            detach(entity);
+        }
+
+        record.archetype = target;
+        record.row = row;
+        return row;
+    }
+
+    // Drop an entity's row from its current archetype
+    void detach(Entity::ID entity) {
+        Record& record = records[Entity::indexOf(entity)];
+        Entity::ID moved = record.archetype->removeRow(record.row);
+        if (moved != Entity::Invalid) {
+            records[Entity::indexOf(moved)].row = record.row;
+        }
+        record.archetype = nullptr;
+        record.row = 0;
+    }
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+// Size of the play area. The game takes it from its window; headless runs choose their own.
+struct Arena {
+    float width;
+    float height;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "CollisionTable.h"
+#include "Entity.h"
+
+// One colliding pair reported by CollisionSystem, with what the collision does to each side
+struct CollisionEvent {
+    Entity::ID a;
+    Entity::ID b;
+    CollisionResponse response;
+};
+
+// Ring buffer of collision events. CollisionSystem pushes a frame's events in detection order,
+// the resolver systems read them as a batch and the last resolver pops them.
+// Storage only changes in reserve(), so a frame that fits doesn't allocate.
+class CollisionEventQueue {
+public:
+    explicit CollisionEventQueue(size_t capacity = 64) : mask(0), head(0), tail(0), dropped(0) {
+        reserve(capacity);
+    }
+
+    // Grow to hold at least capacity events, keeping any that are still queued
+    void reserve(size_t capacity) {
+        size_t ringSize = 1;
+        while (ringSize < capacity) {
+            ringSize <<= 1;
+        }
+        if (ringSize <= events.size()) return;
+
+        std::vector<CollisionEvent> grown(ringSize);
+        for (size_t i = 0; i < size(); ++i) {
+            grown[i] = (*this)[i];
+        }
+        tail = size();
+        head = 0;
+        events.swap(grown);
+        mask = ringSize - 1;
+    }
+
+    // Queue an event; when full the event is dropped and counted instead
+    bool push(const CollisionEvent& event) {
+        if (size() == events.size()) {
+            ++dropped;
+            return false;
+        }
+        events[tail++ & mask] = event;
+        return true;
+    }
+
+    // Discard the oldest count events
+    void pop(size_t count) {
+        head += std::min(count, size());
+    }
+
+    void clear() { head = tail; }
+
+    // i-th queued event, oldest first
+    const CollisionEvent& operator[](size_t i) const { return events[(head + i) & mask]; }
+
+    // Call fn(const CollisionEvent&) for every queued event, oldest first
+    template <typename Func>
+    void each(Func fn) const {
+        for (size_t i = head; i != tail; ++i) {
+            fn(events[i & mask]);
+        }
+    }
+
+    size_t size() const { return tail - head; }
+    bool empty() const { return head == tail; }
+    size_t capacity() const { return events.size(); }
+
+    // Events lost to a full queue since construction
+    size_t getDropped() const { return dropped; }
+
+private:
+    std::vector<CollisionEvent> events;
+    size_t mask;
+    size_t head;  // Running count of popped events
+    size_t tail;  // Running count of pushed events
+    size_t dropped;
+};
@@ -0,0 +1,148 @@
+#include "CollisionKernels.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_KERNELS_SSE2
+#endif
+
+namespace CollisionKernels {
+
+void boxVsBoxesScalar(const sf::FloatRect& box, const BoxArrays& boxes, size_t begin, std::uint64_t* hits) {
+	float right = box.left + box.width;
+	float bottom = box.top + box.height;
+
+	for (size_t i = begin; i < boxes.size(); ++i) {
+		float interLeft = std::max(box.left, boxes.left[i]);
+		float interTop = std::max(box.top, boxes.top[i]);
+		float interRight = std::min(right, boxes.left[i] + boxes.width[i]);
+		float interBottom = std::min(bottom, boxes.top[i] + boxes.height[i]);
+
+		if (interLeft < interRight && interTop < interBottom) {
+			hits[i / 64] |= std::uint64_t(1) << (i % 64);
+		}
+	}
+}
+
+void circleVsBoxesScalar(const sf::Vector2f& center, float radius, const BoxArrays& boxes, size_t begin, std::uint64_t* hits) {
+	float radiusSquared = radius * radius;
+
+	for (size_t i = begin; i < boxes.size(); ++i) {
+		// Closest point on the box to the circle centre
+		float closestX = std::min(std::max(center.x, boxes.left[i]), boxes.left[i] + boxes.width[i]);
+		float closestY = std::min(std::max(center.y, boxes.top[i]), boxes.top[i] + boxes.height[i]);
+
+		float dx = closestX - center.x;
+		float dy = closestY - center.y;
+
+		if (dx * dx + dy * dy <= radiusSquared) {
+			hits[i / 64] |= std::uint64_t(1) << (i % 64);
+		}
+	}
+}
+
+void boxVsBoxes(const sf::FloatRect& box, const BoxArrays& boxes, std::uint64_t* hits) {
+	std::memset(hits, 0, maskWords(boxes.size()) * sizeof(std::uint64_t));
+	size_t i = 0;
+
+#if defined(COLLISION_KERNELS_AVX2)
+	const __m256 left = _mm256_set1_ps(box.left);
+	const __m256 top = _mm256_set1_ps(box.top);
+	const __m256 right = _mm256_set1_ps(box.left + box.width);
+	const __m256 bottom = _mm256_set1_ps(box.top + box.height);
+
+	for (; i + 8 <= boxes.size(); i += 8) {
+		__m256 otherLeft = _mm256_loadu_ps(&boxes.left[i]);
+		__m256 otherTop = _mm256_loadu_ps(&boxes.top[i]);
+		__m256 otherRight = _mm256_add_ps(otherLeft, _mm256_loadu_ps(&boxes.width[i]));
+		__m256 otherBottom = _mm256_add_ps(otherTop, _mm256_loadu_ps(&boxes.height[i]));
+
+		__m256 overlapX = _mm256_cmp_ps(_mm256_max_ps(left, otherLeft), _mm256_min_ps(right, otherRight), _CMP_LT_OQ);
+		__m256 overlapY = _mm256_cmp_ps(_mm256_max_ps(top, otherTop), _mm256_min_ps(bottom, otherBottom), _CMP_LT_OQ);
+
+		std::uint64_t bits = static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY)));
+		hits[i / 64] |= bits << (i % 64);
+	}
+#elif defined(COLLISION_KERNELS_SSE2)
+	const __m128 left = _mm_set1_ps(box.left);
+	const __m128 top = _mm_set1_ps(box.top);
+	const __m128 right = _mm_set1_ps(box.left + box.width);
+	const __m128 bottom = _mm_set1_ps(box.top + box.height);
+
+	for (; i + 4 <= boxes.size(); i += 4) {
+		__m128 otherLeft = _mm_loadu_ps(&boxes.left[i]);
+		__m128 otherTop = _mm_loadu_ps(&boxes.top[i]);
+		__m128 otherRight = _mm_add_ps(otherLeft, _mm_loadu_ps(&boxes.width[i]));
+		__m128 otherBottom = _mm_add_ps(otherTop, _mm_loadu_ps(&boxes.height[i]));
+
+		__m128 overlapX = _mm_cmplt_ps(_mm_max_ps(left, otherLeft), _mm_min_ps(right, otherRight));
+		__m128 overlapY = _mm_cmplt_ps(_mm_max_ps(top, otherTop), _mm_min_ps(bottom, otherBottom));
+
+		std::uint64_t bits = static_cast<std::uint64_t>(_mm_movemask_ps(_mm_and_ps(overlapX, overlapY)));
+		hits[i / 64] |= bits << (i % 64);
+	}
+#endif
+
+	boxVsBoxesScalar(box, boxes, i, hits);
+}
+
+void circleVsBoxes(const sf::Vector2f& center, float radius, const BoxArrays& boxes, std::uint64_t* hits) {
+	std::memset(hits, 0, maskWords(boxes.size()) * sizeof(std::uint64_t));
+	size_t i = 0;
+
+#if defined(COLLISION_KERNELS_AVX2)
+	const __m256 centerX = _mm256_set1_ps(center.x);
+	const __m256 centerY = _mm256_set1_ps(center.y);
+	const __m256 radiusSquared = _mm256_set1_ps(radius * radius);
+
+	for (; i + 8 <= boxes.size(); i += 8) {
+		__m256 left = _mm256_loadu_ps(&boxes.left[i]);
+		__m256 top = _mm256_loadu_ps(&boxes.top[i]);
+		__m256 right = _mm256_add_ps(left, _mm256_loadu_ps(&boxes.width[i]));
+		__m256 bottom = _mm256_add_ps(top, _mm256_loadu_ps(&boxes.height[i]));
+
+		__m256 dx = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(centerX, left), right), centerX);
+		__m256 dy = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(centerY, top), bottom), centerY);
+		__m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+		std::uint64_t bits = static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, radiusSquared, _CMP_LE_OQ)));
+		hits[i / 64] |= bits << (i % 64);
+	}
+#elif defined(COLLISION_KERNELS_SSE2)
+	const __m128 centerX = _mm_set1_ps(center.x);
+	const __m128 centerY = _mm_set1_ps(center.y);
+	const __m128 radiusSquared = _mm_set1_ps(radius * radius);
+
+	for (; i + 4 <= boxes.size(); i += 4) {
+		__m128 left = _mm_loadu_ps(&boxes.left[i]);
+		__m128 top = _mm_loadu_ps(&boxes.top[i]);
+		__m128 right = _mm_add_ps(left, _mm_loadu_ps(&boxes.width[i]));
+		__m128 bottom = _mm_add_ps(top, _mm_loadu_ps(&boxes.height[i]));
+
+		__m128 dx = _mm_sub_ps(_mm_min_ps(_mm_max_ps(centerX, left), right), centerX);
+		__m128 dy = _mm_sub_ps(_mm_min_ps(_mm_max_ps(centerY, top), bottom), centerY);
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+		std::uint64_t bits = static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared)));
+		hits[i / 64] |= bits << (i % 64);
+	}
+#endif
+
+	circleVsBoxesScalar(center, radius, boxes, i, hits);
+}
+
+const char* instructionSet() {
+#if defined(COLLISION_KERNELS_AVX2)
+	return "AVX2";
+#elif defined(COLLISION_KERNELS_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+}
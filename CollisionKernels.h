@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Axis-aligned boxes in structure-of-arrays form, so the batch kernels can load several at once
+struct BoxArrays {
+    std::vector<float> left;
+    std::vector<float> top;
+    std::vector<float> width;
+    std::vector<float> height;
+
+    void clear() {
+        left.clear();
+        top.clear();
+        width.clear();
+        height.clear();
+    }
+
+    void push_back(const sf::FloatRect& bounds) {
+        left.push_back(bounds.left);
+        top.push_back(bounds.top);
+        width.push_back(bounds.width);
+        height.push_back(bounds.height);
+    }
+
+    size_t size() const { return left.size(); }
+};
+
+// Batched narrowphase: test one collider against every box in a BoxArrays and set bit i of the
+// hit mask (word i / 64, bit i % 64) when box i overlaps. The vector width is chosen at build
+// time: AVX2 when the compiler targets it, SSE2 on any x86-64 build, scalar otherwise.
+// Every path evaluates the same expressions as the scalar tests.
+namespace CollisionKernels {
+    // Number of 64-bit words needed for a mask over count boxes
+    inline size_t maskWords(size_t count) { return (count + 63) / 64; }
+
+    // Index of the lowest set bit of a hit mask word; bits must not be zero
+    inline unsigned int lowestBit(std::uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<unsigned int>(index);
+#else
+        return static_cast<unsigned int>(__builtin_ctzll(bits));
+#endif
+    }
+
+    // Same test as sf::FloatRect::intersects for boxes with non-negative size
+    void boxVsBoxes(const sf::FloatRect& box, const BoxArrays& boxes, std::uint64_t* hits);
+
+    // Same test as CollisionSystem::checkBoxCircleCollision
+    void circleVsBoxes(const sf::Vector2f& center, float radius, const BoxArrays& boxes, std::uint64_t* hits);
+
+    // Portable versions, also used for the tail the vector loops leave over
+    void boxVsBoxesScalar(const sf::FloatRect& box, const BoxArrays& boxes, size_t begin, std::uint64_t* hits);
+    void circleVsBoxesScalar(const sf::Vector2f& center, float radius, const BoxArrays& boxes, size_t begin, std::uint64_t* hits);
+
+    // "AVX2", "SSE2" or "scalar"
+    const char* instructionSet();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include "Components.h"
+
+// Effects a collision can have on one of the two entities involved
+enum CollisionEffect : std::uint8_t {
+    NoEffect = 0,
+    TakeDamage = 1 << 0,  // Lose one health, if it has Health
+    SpeedUp = 1 << 1,  // Rotation speed power-up
+    SizeUp = 1 << 2,  // Size power-up
+    Despawn = 1 << 3  // Return to the projectile pool
+};
+
+// Effects of one collision on each entity of the pair
+struct CollisionResponse {
+    std::uint8_t a = NoEffect;
+    std::uint8_t b = NoEffect;
+
+    bool empty() const { return (a | b) == NoEffect; }
+};
+
+// Dispatch table of collision responses for every (kindA, kindB) pair, so resolving a
+// collision is a single lookup instead of inspecting components
+class CollisionTable {
+public:
+    static CollisionResponse lookup(EntityKind a, EntityKind b) {
+        return table().responses[static_cast<int>(a)][static_cast<int>(b)];
+    }
+
+private:
+    static constexpr int KindCount = static_cast<int>(EntityKind::Count);
+
+    struct Table {
+        CollisionResponse responses[KindCount][KindCount];
+    };
+
+    // Gameplay rules: what hitting other does to self
+    static constexpr std::uint8_t effectOn(EntityKind self, EntityKind other) {
+        std::uint8_t effect = NoEffect;
+
+        // Projectiles and power-ups are used up by whatever they hit
+        if (self == EntityKind::Projectile || self == EntityKind::SpeedPowerUp || self == EntityKind::SizePowerUp) {
+            effect |= Despawn;
+        }
+        if (other == EntityKind::Projectile) {
+            effect |= TakeDamage;
+        }
+        if (self == EntityKind::Player && other == EntityKind::SpeedPowerUp) {
+            effect |= SpeedUp;
+        }
+        if (self == EntityKind::Player && other == EntityKind::SizePowerUp) {
+            effect |= SizeUp;
+        }
+        return effect;
+    }
+
+    static constexpr Table build() {
+        Table result{};
+        for (int a = 0; a < KindCount; ++a) {
+            for (int b = 0; b < KindCount; ++b) {
+                result.responses[a][b].a = effectOn(static_cast<EntityKind>(a), static_cast<EntityKind>(b));
+                result.responses[a][b].b = effectOn(static_cast<EntityKind>(b), static_cast<EntityKind>(a));
+            }
+        }
+        return result;
+    }
+
+    static const Table& table() {
+        static constexpr Table responses = build();
+        return responses;
+    }
+};
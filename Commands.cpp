@@ -42,3 +42,23 @@ void IncreaseRotationSpeedCommand::execute(ComponentManager& manager, Entity::ID
         rotation->speed += 50.f;
     }
 }
+
+void PlayerInput::execute(std::uint8_t input, ComponentManager& manager, Entity::ID player) {
+    RotateClockwiseCommand rotateClockwise;
+    RotateAntiClockwiseCommand rotateAntiClockwise;
+    IncreaseRadiusCommand increaseRadius;
+    DecreaseRadiusCommand decreaseRadius;
+
+    if (input & RotateClockwise) {
+        rotateClockwise.execute(manager, player);
+    }
+    if (input & RotateAntiClockwise) {
+        rotateAntiClockwise.execute(manager, player);
+    }
+    if (input & IncreaseRadius) {
+        increaseRadius.execute(manager, player);
+    }
+    if (input & DecreaseRadius) {
+        decreaseRadius.execute(manager, player);
+    }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include "ComponentManager.h"
 
 class Command {
@@ -35,4 +36,18 @@ public:
 class IncreaseRotationSpeedCommand : public Command {
 public:
     void execute(ComponentManager& manager, Entity::ID entity) override;
-};
\ No newline at end of file
+};
+
+// The commands the player can issue in one tick, one bit each, so a tick's whole input is a
+// byte that InputRecorder can log and a replay can feed back in
+namespace PlayerInput {
+    enum : std::uint8_t {
+        RotateClockwise = 1 << 0,
+        RotateAntiClockwise = 1 << 1,
+        IncreaseRadius = 1 << 2,
+        DecreaseRadius = 1 << 3
+    };
+
+    // Run the command for each bit set in input, always in the same order
+    void execute(std::uint8_t input, ComponentManager& manager, Entity::ID player);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include <atomic>
+
+// Assigns each type a small sequential ID the first time it is used within a category.
+// The ID indexes the ComponentManager's arrays directly, so no RTTI or hashing is needed.
+template <typename Category>
+class TypeFamily {
+public:
+    using ID = unsigned int;
+
+    template <typename T>
+    static ID id() {
+        static const ID familyId = nextId++;
+        return familyId;
+    }
+
+private:
+    inline static std::atomic<ID> nextId{ 0 };  // Types can be seen for the first time on several threads at once
+};
+
+using ComponentFamily = TypeFamily<struct ComponentCategory>;  // One ID per component type
+using ViewFamily = TypeFamily<struct ViewCategory>;  // One ID per View<Ts...> instantiation
+using GroupFamily = TypeFamily<struct GroupCategory>;  // One ID per Group<Ts...> instantiation
+using AccessFamily = TypeFamily<struct AccessCategory>;  // One ID per type a system declares access to
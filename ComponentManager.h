@@ -1,119 +1,225 @@
-    #pragma once
-    #include <unordered_map>
-    #include <typeindex>
-    #include <vector>
-    #include "Entity.h"
-    #include "Components.h"
-
-    class ComponentManager {
-    public:
-        template <typename T>
-        void addComponent(Entity::ID entity, T component) {
-            components[typeid(T)][entity] = new T(component);
-            inUse[entity] = true;
-        }
-
-        template <typename T>
-        void removeComponent(Entity::ID entity) {
-            components[typeid(T)].erase(entity);
-        }
-
-        template <typename T>
-        T* getComponent(Entity::ID entity) {
-            auto it = components[typeid(T)].find(entity);
-            if (it != components[typeid(T)].end()) {
-                return static_cast<T*>(it->second);
-            }
-            return nullptr;
-        }
-
-        template <typename... Components>
-        std::vector<Entity::ID> getEntitiesWithComponents() {
-            std::vector<Entity::ID> result;
-
-            if constexpr (sizeof...(Components) > 0) {
-                // Retrieve entities with the first component or its derived types
-                result = getEntitiesWithComponentHelper<typename std::tuple_element<0, std::tuple<Components...>>::type>();
-
-                // Filter based on other components
-                for (auto entity = result.begin(); entity != result.end();) {
-                    if (!hasAllComponents<Components...>(*entity)) {
-                        entity = result.erase(entity);
-                    }
-                    else {
-                        ++entity;
-                    }
-                }
-            }
-
-            return result;
+#pragma once
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Entity.h"
+#include "Components.h"
+#include "ComponentFamily.h"
+#include "ComponentPool.h"
+#include "View.h"
+#include "Group.h"
+#include "JobScheduler.h"
+#include "ArchetypeComponentManager.h"
+
+// Default component storage: one sparse-set pool per component type.
+// Entities are addressed by generational IDs (see Entity); lookups with a stale ID find nothing.
+class SparseSetComponentManager {
+public:
+    template <typename T>
+    void addComponent(Entity::ID entity, T component) {
+        static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
+        ComponentPool<T>& pool = getPool<T>();
+
+        Entity::ID previous = pool.occupant(entity);
+        if (previous != Entity::Invalid && previous != entity) {
+            destroyEntity(previous);  // The slot was recycled without clearing its old generation
         }
 
-        template <typename ComponentType>
-        std::vector<Entity::ID> getEntitiesWithComponentHelper() {
-            std::vector<Entity::ID> result;
-
-            for (auto& componentPair : components) {
-                for (auto& entityPair : componentPair.second) {
-                    Entity::ID entityId = entityPair.first;
-                    Component* componentPtr = entityPair.second;
-
-                    // Check if the component is exactly the requested type or a derived type
-                    if (dynamic_cast<ComponentType*>(componentPtr)) {
-                        result.push_back(entityId);
-                    }
-                }
+        pool.add(entity, std::move(component));
+        setEntityInUse(entity, true);
+        notifyGroups(ComponentFamily::id<T>(), entity, true);
+        notifyViews(ComponentFamily::id<T>(), entity, true);
+    }
+
+    template <typename T>
+    void removeComponent(Entity::ID entity) {
+        ComponentPool<T>* pool = findPool<T>();
+        if (pool && pool->has(entity)) {
+            notifyGroups(ComponentFamily::id<T>(), entity, false);
+            pool->remove(entity);
+            notifyViews(ComponentFamily::id<T>(), entity, false);
+        }
+    }
+
+    // Remove every component of the entity and mark it unused, so its slot can be recycled
+    void destroyEntity(Entity::ID entity) {
+        for (size_t family = 0; family < pools.size(); ++family) {
+            if (pools[family] && pools[family]->has(entity)) {
+                notifyGroups(static_cast<ComponentFamily::ID>(family), entity, false);
+                pools[family]->remove(entity);
+                notifyViews(static_cast<ComponentFamily::ID>(family), entity, false);
             }
-
-            return result;
+        }
+        setEntityInUse(entity, false);
+    }
+
+    template <typename T>
+    T* getComponent(Entity::ID entity) {
+        ComponentPool<T>* pool = findPool<T>();
+        return pool ? pool->get(entity) : nullptr;
+    }
+
+    // Persistent query for all entities with every component in Ts.
+    // Built on first use and then updated incrementally, so repeated calls are O(1).
+    // Building one isn't thread-safe; see setSystemsRunning.
+    template <typename... Ts>
+    View<Ts...>& view() {
+        ViewFamily::ID family = ViewFamily::id<View<Ts...>>();
+        if (family >= views.size()) {
+            views.resize(family + 1);
         }
 
-        bool isEntityInUse(Entity::ID entity) const {
-            auto it = inUse.find(entity);
-            return (it != inUse.end()) ? it->second : false;
+        std::unique_ptr<IView>& view = views[family];
+        if (!view) {
+            assert(!systemsRunning && "View built while systems run in parallel; build it before the first tick");
+            view = std::make_unique<View<Ts...>>(getPool<Ts>()...);
+            (subscribeView<Ts>(view.get()), ...);
+        }
+        return *static_cast<View<Ts...>*>(view.get());
+    }
+
+    // Group over Ts, which keeps the entities with all of them row-aligned at the front of each
+    // pool (see Group). Built on first use. A component type can be in one group only.
+    template <typename... Ts>
+    Group<Ts...>& group() {
+        GroupFamily::ID family = GroupFamily::id<Group<Ts...>>();
+        if (family >= groups.size()) {
+            groups.resize(family + 1);
         }
 
-        void setEntityInUse(Entity::ID entity, bool use) {
-            inUse[entity] = use;
+        std::unique_ptr<IGroup>& group = groups[family];
+        if (!group) {
+            assert(!systemsRunning && "Group built while systems run in parallel; build it before the first tick");
+            group = std::make_unique<Group<Ts...>>(getPool<Ts>()...);
+            (subscribeGroup<Ts>(group.get()), ...);
+        }
+        return *static_cast<Group<Ts...>*>(group.get());
+    }
+
+    // Call func(entity, T&, Others&...) for every entity that has all the given components
+    template <typename T, typename... Others, typename Func>
+    void forEach(Func func) {
+        view<T, Others...>().each(func);
+    }
+
+    // forEach with the view's dense member array split across scheduler's threads, in ranges a
+    // whole number of cache lines of member IDs long. func runs concurrently, so it may only write
+    // the components it is given. It may also read other components and isEntityInUse, provided
+    // nothing running alongside writes them; no call may add or remove components. Views under
+    // ParallelMinimum entities run serially.
+    template <typename T, typename... Others, typename Func>
+    void parallelForEach(JobScheduler& scheduler, Func func) {
+        View<T, Others...>& members = view<T, Others...>();
+        size_t grain = scheduler.grainFor(members.size(), CacheLineBytes / sizeof(Entity::ID), ParallelMinimum);
+        scheduler.parallelFor(members.size(), grain, [&](size_t begin, size_t end) {
+            members.eachInRange(begin, end, func);
+        });
+    }
+
+    static constexpr size_t ParallelMinimum = 4096;  // Below this a split costs more than it saves
+    static constexpr size_t CacheLineBytes = 64;
+
+    template <typename T>
+    ComponentPool<T>& getPool() {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        if (family >= pools.size()) {
+            pools.resize(family + 1);
         }
 
-        ~ComponentManager() {
-            for (auto& pair : components) {
-                for (auto& entityComp : pair.second) {
-                    delete entityComp.second;
-                }
-            }
+        std::unique_ptr<IComponentPool>& pool = pools[family];
+        if (!pool) {
+            pool = std::make_unique<ComponentPool<T>>();
         }
+        return *static_cast<ComponentPool<T>*>(pool.get());
+    }
+
+    // Set while a SystemGraph may be running systems side by side. Building a view or group then
+    // asserts, since two systems could race to build the same one; build them all beforehand.
+    void setSystemsRunning(bool running) { systemsRunning = running; }
+
+    bool isEntityInUse(Entity::ID entity) const {
+        Entity::ID slot = Entity::indexOf(entity);
+        return slot < inUse.size() && inUse[slot] == entity;
+    }
+
+    void setEntityInUse(Entity::ID entity, bool use) {
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= inUse.size()) {
+            inUse.resize(slot + 1, Entity::Invalid);
+        }
+        if (use) {
+            inUse[slot] = entity;
+        }
+        else if (inUse[slot] == entity) {  // A stale ID can't deactivate the slot's new occupant
+            inUse[slot] = Entity::Invalid;
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<IComponentPool>> pools;  // Indexed by ComponentFamily ID
+    std::vector<std::unique_ptr<IView>> views;  // Indexed by ViewFamily ID
+    std::vector<std::vector<IView*>> viewsByComponent;  // Views to notify, indexed by ComponentFamily ID
+    std::vector<std::unique_ptr<IGroup>> groups;  // Indexed by GroupFamily ID
+    std::vector<IGroup*> groupByComponent;  // The group owning each pool, indexed by ComponentFamily ID
+    std::vector<Entity::ID> inUse;  // Indexed by entity index, the active ID in that slot or Entity::Invalid
+    bool systemsRunning = false;
+
+    // Returns nullptr rather than creating a pool, so lookups never allocate
+    template <typename T>
+    ComponentPool<T>* findPool() {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        return (family < pools.size()) ? static_cast<ComponentPool<T>*>(pools[family].get()) : nullptr;
+    }
+
+    template <typename T>
+    void subscribeView(IView* view) {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        if (family >= viewsByComponent.size()) {
+            viewsByComponent.resize(family + 1);
+        }
+        viewsByComponent[family].push_back(view);
+    }
+
+    template <typename T>
+    void subscribeGroup(IGroup* group) {
+        ComponentFamily::ID family = ComponentFamily::id<T>();
+        if (family >= groupByComponent.size()) {
+            groupByComponent.resize(family + 1, nullptr);
+        }
+        assert(!groupByComponent[family] && "A component type can belong to one group only");
+        groupByComponent[family] = group;
+    }
 
-    private:
-        std::unordered_map<std::type_index, std::unordered_map<Entity::ID, Component*>> components;
-        std::unordered_map<Entity::ID, bool> inUse;
+    // Groups hear about a removal before the pool makes it, so they can first move the entity out
+    void notifyGroups(ComponentFamily::ID family, Entity::ID entity, bool added) {
+        if (family >= groupByComponent.size() || !groupByComponent[family]) return;
 
-        template <typename T>
-        std::vector<Entity::ID> getEntitiesWithComponent() {
-            std::vector<Entity::ID> entities;
-            auto it = components.find(typeid(T));
-            if (it != components.end()) {
-                for (const auto& pair : it->second) {
-                    entities.push_back(pair.first);
-                }
-            }
-            return entities;
+        if (added) {
+            groupByComponent[family]->onComponentAdded(entity);
+        }
+        else {
+            groupByComponent[family]->onComponentRemoving(entity);
         }
+    }
+
+    void notifyViews(ComponentFamily::ID family, Entity::ID entity, bool added) {
+        if (family >= viewsByComponent.size()) return;
 
-        template <typename First, typename... Rest>
-        bool hasAllComponents(Entity::ID entity) {
-            if (!hasComponent<First>(entity)) {
-                return false;
+        for (IView* view : viewsByComponent[family]) {
+            if (added) {
+                view->onComponentAdded(entity);
             }
-            if constexpr (sizeof...(Rest) > 0) {
-                return hasAllComponents<Rest...>(entity);
+            else {
+                view->onComponentRemoved(entity);
             }
-            return true;
-        }
-
-        template <typename T>
-        bool hasComponent(Entity::ID entity) {
-            return components[typeid(T)].count(entity) > 0;
         }
-    };
+    }
+};
+
+#ifdef CENTRAL_DEFENCE_ARCHETYPE_STORAGE
+using ComponentManager = ArchetypeComponentManager;
+#else
+using ComponentManager = SparseSetComponentManager;
+#endif
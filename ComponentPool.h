@@ -0,0 +1,106 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "Entity.h"
+
+// Type-erased base so the ComponentManager can own pools of every component type
+class IComponentPool {
+public:
+    virtual ~IComponentPool() = default;
+    virtual void remove(Entity::ID entity) = 0;
+    virtual bool has(Entity::ID entity) const = 0;
+    virtual Entity::ID occupant(Entity::ID entity) const = 0;
+    virtual size_t size() const = 0;
+};
+
+// Sparse-set storage for a single component type.
+// Components live by value in a dense array, and 'sparse' maps an entity index to its dense index.
+// The dense side keeps the full ID, so a stale handle to a recycled slot finds nothing.
+// Add, remove and lookup are all O(1); removal swaps the last element into the freed slot.
+// Pointers returned by get() stay valid until the next add() or remove() on this pool.
+template <typename T>
+class ComponentPool : public IComponentPool {
+public:
+    void add(Entity::ID entity, T component) {
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= sparse.size()) {
+            sparse.resize(slot + 1, npos);
+        }
+
+        if (sparse[slot] != npos) {  // Slot already has this component, overwrite it
+            dense[sparse[slot]] = std::move(component);
+            denseEntities[sparse[slot]] = entity;
+            return;
+        }
+
+        sparse[slot] = static_cast<unsigned int>(dense.size());
+        dense.push_back(std::move(component));
+        denseEntities.push_back(entity);
+    }
+
+    void remove(Entity::ID entity) override {
+        if (!has(entity)) return;
+
+        // Move the last component into the removed slot to keep the array packed
+        unsigned int index = sparse[Entity::indexOf(entity)];
+        unsigned int last = static_cast<unsigned int>(dense.size() - 1);
+        if (index != last) {
+            dense[index] = std::move(dense[last]);
+            denseEntities[index] = denseEntities[last];
+            sparse[Entity::indexOf(denseEntities[index])] = index;
+        }
+
+        dense.pop_back();
+        denseEntities.pop_back();
+        sparse[Entity::indexOf(entity)] = npos;
+    }
+
+    T* get(Entity::ID entity) {
+        return has(entity) ? &dense[sparse[Entity::indexOf(entity)]] : nullptr;
+    }
+
+    bool has(Entity::ID entity) const override {
+        Entity::ID slot = Entity::indexOf(entity);
+        return slot < sparse.size() && sparse[slot] != npos && denseEntities[sparse[slot]] == entity;
+    }
+
+    // ID holding the entity's slot in this pool, possibly an older generation, or Entity::Invalid
+    Entity::ID occupant(Entity::ID entity) const override {
+        Entity::ID slot = Entity::indexOf(entity);
+        return (slot < sparse.size() && sparse[slot] != npos) ? denseEntities[sparse[slot]] : Entity::Invalid;
+    }
+
+    size_t size() const override {
+        return dense.size();
+    }
+
+    // Position of an entity's component in the packed array; the entity must have one
+    unsigned int indexOf(Entity::ID entity) const {
+        return sparse[Entity::indexOf(entity)];
+    }
+
+    // Exchange two entries of the packed array, for Group to reorder the pools it owns
+    void swapEntries(unsigned int a, unsigned int b) {
+        if (a == b) return;
+        std::swap(dense[a], dense[b]);
+        std::swap(denseEntities[a], denseEntities[b]);
+        sparse[Entity::indexOf(denseEntities[a])] = a;
+        sparse[Entity::indexOf(denseEntities[b])] = b;
+    }
+
+    // Packed component array, parallel to entities()
+    std::vector<T>& components() {
+        return dense;
+    }
+
+    const std::vector<Entity::ID>& entities() const {
+        return denseEntities;
+    }
+
+private:
+    static constexpr unsigned int npos = ~0u;  // Marks an entity with no component in this pool
+
+    std::vector<T> dense;
+    std::vector<Entity::ID> denseEntities;
+    std::vector<unsigned int> sparse;  // Indexed by Entity::indexOf
+};
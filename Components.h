@@ -2,18 +2,17 @@
 
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include "SinCosTable.h"
 
-struct Component {
-	virtual ~Component() = default;
-};
+// Tag base for all components. Components are plain data stored by value in their pool,
+// so they carry no virtual functions.
+struct Component {};
 
 struct Velocity : public Component {
 	float dx, dy;
 
 	Velocity(float dx = 0.f, float dy = 0.f)
 		: dx(dx), dy(dy) {}
-
-	virtual ~Velocity() override = default;
 };
 
 struct Rotation : public Component {
@@ -26,15 +25,24 @@ struct Rotation : public Component {
 	float radius;
 	float maxRadius;
 	float minRadius;
+	float directionX, directionY;  // Unit vector at angle, turned a step at a time by RotationSystem
+	float stepAngle, stepCos, stepSin;  // Last per-tick increment and its rotation, reused while it holds
 
 	Rotation(float angle = 0.f, float startSpeed = 0.f, bool clockwise = true,
 		float centerX = 0.f, float centerY = 0.f, float radius = 0.f,
 		float maxRadius = 0.f, float minRadius = 0.f)
 		: angle(angle), speed(startSpeed), startSpeed(startSpeed), clockwise(clockwise),
 		centerX(centerX), centerY(centerY), radius(radius), maxRadius(maxRadius),
-		minRadius(minRadius) {}
+		minRadius(minRadius), stepAngle(0.f), stepCos(1.f), stepSin(0.f) {
+		setAngle(angle);
+	}
 
-	virtual ~Rotation() override = default;
+	// Jump to an angle in degrees. Writing angle directly leaves the direction behind until
+	// RotationSystem next re-derives it.
+	void setAngle(float degrees) {
+		angle = degrees;
+		SinCosTable::lookup(degrees, directionY, directionX);
+	}
 
 	void increaseRadius(float amount) {
 		radius += amount;
@@ -57,18 +65,16 @@ struct Health : public Component{
 	int maxHealth;
 
 	Health(int maxHealth) : currentHealth(maxHealth), maxHealth(maxHealth) {}
-
-	virtual ~Health() override = default;
 };
 
+// Points at a shape owned elsewhere, often a prototype shared by every entity of a kind (Shapes.h),
+// so copying or removing a Renderable never allocates or frees
 struct Renderable : public Component {
 	sf::Shape* shape;
 	sf::Sprite* sprite; // Optional: If using textures instead of simple shapes
 
 	Renderable(sf::Shape* shape = nullptr, sf::Sprite* sprite = nullptr)
 		: shape(shape), sprite(sprite) {}
-
-	virtual ~Renderable() override = default;
 };
 
 struct Transform : public Component {
@@ -77,14 +83,41 @@ struct Transform : public Component {
 
 	Transform(float x = 0.f, float y = 0.f, float angle = 0.f)
 		: x(x), y(y), angle(angle) {}
+};
+
+// Where an entity was at the start of the current simulation tick, so rendering can draw it
+// between ticks. Entities without one are drawn at their Transform.
+struct PreviousTransform : public Component {
+	float x, y;
+	float angle;
+
+	PreviousTransform(float x = 0.f, float y = 0.f, float angle = 0.f)
+		: x(x), y(y), angle(angle) {}
 
-	virtual ~Transform() override = default;
+	PreviousTransform(const Transform& transform)
+		: x(transform.x), y(transform.y), angle(transform.angle) {}
 };
 
-struct Collider : public Component {
-	virtual ~Collider() = default;
+// What an entity is, for gameplay rules that shouldn't depend on how it is drawn
+enum class EntityKind : unsigned char {
+	None,
+	Player,
+	Base,
+	Projectile,
+	SpeedPowerUp,
+	SizePowerUp,
+	Count
 };
 
+struct Tag : public Component {
+	EntityKind kind;
+
+	Tag(EntityKind kind = EntityKind::None)
+		: kind(kind) {}
+};
+
+struct Collider : public Component {};
+
 // Circle collider for base
 struct CircleCollider : public Collider {
 	sf::Vector2f center;  // Center position of the circle collider
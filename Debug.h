@@ -2,47 +2,163 @@
 
 #include <SFML/Graphics.hpp>
 #include "ComponentManager.h"
+#include "Profiler.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 class Debug {
 public:
-    void renderColliders(ComponentManager& manager, sf::RenderWindow& window) {
-        auto boxEntities = manager.getEntitiesWithComponents<BoxCollider>();
-        for (auto entity : boxEntities) {
-            BoxCollider* collider = manager.getComponent<BoxCollider>(entity);
+    // Outline every collider in green. The outlines are built as line vertices in frameMemory and
+    // drawn in one call, so nothing is allocated per collider.
+    void renderColliders(ComponentManager& manager, sf::RenderWindow& window, std::pmr::memory_resource& frameMemory) {
+        std::pmr::vector<sf::Vertex> lines(&frameMemory);
 
-            if (!collider || !manager.isEntityInUse(entity)) {
+        for (auto [entity, collider] : manager.view<BoxCollider>()) {
+            if (!manager.isEntityInUse(entity)) {
                 continue; // Skip entity if not in use
             }
 
-            if (auto* boxCollider = dynamic_cast<BoxCollider*>(collider)) {
-                // Render box collider
-                sf::RectangleShape shape(sf::Vector2f(boxCollider->bounds.width, boxCollider->bounds.height));
-                shape.setPosition(boxCollider->bounds.left, boxCollider->bounds.top);
-                shape.setFillColor(sf::Color::Transparent);
-                shape.setOutlineColor(sf::Color::Green);
-                shape.setOutlineThickness(1.f);
-                window.draw(shape);
+            // Render box collider
+            const sf::FloatRect& bounds = collider->bounds;
+            sf::Vector2f corners[4] = {
+                { bounds.left, bounds.top },
+                { bounds.left + bounds.width, bounds.top },
+                { bounds.left + bounds.width, bounds.top + bounds.height },
+                { bounds.left, bounds.top + bounds.height }
+            };
+            for (int i = 0; i < 4; ++i) {
+                lines.emplace_back(corners[i], sf::Color::Green);
+                lines.emplace_back(corners[(i + 1) % 4], sf::Color::Green);
             }
         }
-        auto circleEntities = manager.getEntitiesWithComponents<CircleCollider>();
-        for (auto entity : circleEntities) {
-            CircleCollider* collider = manager.getComponent<CircleCollider>(entity);
-
-            if (!collider || !manager.isEntityInUse(entity)) {
+        for (auto [entity, collider] : manager.view<CircleCollider>()) {
+            if (!manager.isEntityInUse(entity)) {
                 continue;
             }
-            if (auto* circleCollider = dynamic_cast<CircleCollider*>(collider)) {
-                // Render circle collider
-                sf::CircleShape shape(circleCollider->radius);
-                shape.setPosition(circleCollider->center.x - circleCollider->radius, circleCollider->center.y - circleCollider->radius);
-                shape.setFillColor(sf::Color::Transparent);
-                shape.setOutlineColor(sf::Color::Green);
-                shape.setOutlineThickness(1
-                
-                );
-                window.draw(shape);
+            // Render circle collider, with as many segments as sf::CircleShape uses by default
+            const int segments = 30;
+            for (int i = 0; i < segments; ++i) {
+                lines.emplace_back(pointOnCircle(*collider, i, segments), sf::Color::Green);
+                lines.emplace_back(pointOnCircle(*collider, i + 1, segments), sf::Color::Green);
+            }
+        }
+
+        if (!lines.empty()) {
+            window.draw(lines.data(), lines.size(), sf::Lines);
+        }
+    }
+
+    // Call once per frame with the heap allocations the frame thread made while ticking and
+    // rendering, and the simulation ticks it ran. Once WarmupTicks have passed, and pools, views
+    // and scratch buffers have reached their working size, a frame must not allocate at all. The
+    // exceptions: frames where storageGrew, because the game reached a new peak of live entities
+    // and the pools and buffers sized by them had to grow, up to the next frame that runs a tick,
+    // when collision first sees the new entities; and frames this overlay rebuilds its text on.
+    // Warm-up counts ticks rather than frames, since uncapped rendering can draw hundreds of
+    // frames before the first tick.
+    void checkFrameAllocations(size_t allocations, size_t ticks, bool storageGrew) {
+        bool warmingUp = ticksSeen <= WarmupTicks;
+        ticksSeen += ticks;
+        bool expected = warmingUp || storageGrew || storageGrowing || profileTextRebuilt;
+        if (storageGrew || ticks > 0) {
+            storageGrowing = storageGrew;
+        }
+        profileTextRebuilt = false;
+        lastFrameAllocations = allocations;
+        if (allocations == 0) return;
+
+        ++allocatingFrames;
+        assert(expected && "a steady-state frame allocated from the global heap");
+        (void)expected;
+    }
+
+    size_t getLastFrameAllocations() const { return lastFrameAllocations; }
+    size_t getAllocatingFrames() const { return allocatingFrames; }
+
+    // Per-zone timings from Profiler, one row per zone: a bar to the p50 and a fainter one on
+    // to the p99, against a line at one 60 Hz frame. With a font loaded, each row is labelled
+    // with the zone's name and times, under a line of entity counts. Does nothing while the
+    // overlay is hidden or the profiler is compiled out.
+    void renderProfile(ComponentManager& manager, sf::RenderWindow& window, std::pmr::memory_resource& frameMemory) {
+        if (!profileVisible) return;
+
+        Profiler::ZoneStats zones[Profiler::MaxZoneNames];
+        size_t zoneCount = Profiler::stats(zones, Profiler::MaxZoneNames);
+        if (zoneCount == 0) return;
+
+        const float left = 10.f, top = 30.f, rowHeight = 14.f, pixelsPerMs = 20.f;
+        std::pmr::vector<sf::Vertex> bars(&frameMemory);
+        auto addRect = [&](float x0, float y0, float x1, float y1, const sf::Color& colour) {
+            sf::Vector2f corners[4] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+            for (int i : { 0, 1, 2, 0, 2, 3 }) {
+                bars.emplace_back(corners[i], colour);
+            }
+        };
+
+        for (size_t i = 0; i < zoneCount; ++i) {
+            float y = top + i * rowHeight;
+            addRect(left, y, left + zones[i].p99Ms * pixelsPerMs, y + rowHeight - 4.f, sf::Color(255, 160, 0, 90));
+            addRect(left, y, left + zones[i].p50Ms * pixelsPerMs, y + rowHeight - 4.f, sf::Color(255, 160, 0, 220));
+        }
+        float budget = left + 1000.f / 60.f * pixelsPerMs;
+        addRect(budget, top, budget + 1.f, top + zoneCount * rowHeight, sf::Color::White);
+        window.draw(bars.data(), bars.size(), sf::Triangles);
+
+        if (!hasOverlayFont) return;
+
+        // Rebuilding the text allocates, so only refresh it every 30 frames
+        if (framesSinceRefresh++ % 30 == 0) {
+            char line[128];
+            std::string text;
+            std::snprintf(line, sizeof(line), "entities %zu, moving %zu\n",
+                manager.view<Transform>().size(), manager.view<Velocity>().size());
+            text += line;
+            for (size_t i = 0; i < zoneCount; ++i) {
+                std::snprintf(line, sizeof(line), "%-12s p50 %6.3f  p99 %6.3f ms\n", zones[i].name, zones[i].p50Ms, zones[i].p99Ms);
+                text += line;
             }
+            profileText.setString(text);
+            profileTextRebuilt = true;
+        }
+        window.draw(profileText);
+    }
+
+    void toggleProfile() { profileVisible = !profileVisible; }
+
+    // Font for the profile overlay's labels; without one it draws bars only
+    bool loadOverlayFont(const std::string& path) {
+        hasOverlayFont = overlayFont.loadFromFile(path);
+        if (hasOverlayFont) {
+            profileText.setFont(overlayFont);
+            profileText.setCharacterSize(11);
+            profileText.setFillColor(sf::Color::White);
+            profileText.setPosition(370.f, 16.f);
         }
+        return hasOverlayFont;
+    }
+
+private:
+    static sf::Vector2f pointOnCircle(const CircleCollider& collider, int i, int segments) {
+        float angle = i * 2.f * 3.14159265f / segments;
+        return sf::Vector2f(collider.center.x + std::cos(angle) * collider.radius, collider.center.y + std::sin(angle) * collider.radius);
     }
+
+    static constexpr size_t WarmupTicks = 120;  // Two seconds of game time at 60 Hz
+
+    size_t ticksSeen = 0;
+    bool storageGrowing = false;  // Storage grew and no tick has run since
+    size_t lastFrameAllocations = 0;
+    size_t allocatingFrames = 0;
+    bool profileTextRebuilt = false;  // Set by renderProfile on frames that allocate for the text
+
+    bool profileVisible = false;
+    bool hasOverlayFont = false;
+    sf::Font overlayFont;
+    sf::Text profileText;
+    size_t framesSinceRefresh = 0;
 };
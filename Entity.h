@@ -2,7 +2,18 @@
 
 class Entity {
 public:
+    // An ID packs a slot index in the low bits and a generation in the high bits. Storage is
+    // indexed by the slot; recycling a slot bumps its generation, so a handle kept past its
+    // release no longer matches the live entity. Generations wrap after MaxGeneration.
     using ID = unsigned int;
+    static constexpr unsigned int IndexBits = 22;
+    static constexpr ID IndexMask = (1u << IndexBits) - 1;
+    static constexpr ID MaxGeneration = (~0u >> IndexBits) - 1;  // The all-ones generation is left for Invalid
+    static constexpr ID Invalid = ~0u;  // Never assigned to a real entity
+
+    static constexpr ID indexOf(ID id) { return id & IndexMask; }
+    static constexpr ID generationOf(ID id) { return id >> IndexBits; }
+    static constexpr ID makeId(ID index, ID generation) { return (generation << IndexBits) | index; }
 
     explicit Entity(ID id) : id(id), inUse(false) {}
 
@@ -11,5 +22,7 @@ public:
     bool inUse;
 
 private:
+    friend class ObjectPool;  // Bumps the generation when the slot is recycled
+
     ID id;
 };
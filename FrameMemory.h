@@ -0,0 +1,74 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Linear allocator for scratch data that only lives for one frame. Allocation bumps a pointer
+// through a list of blocks, deallocation does nothing, and reset() rewinds to the first block at
+// the top of each frame. Blocks are kept across resets, so once the busiest frame has been seen
+// no frame touches the global heap. Use it through the std::pmr containers, e.g.
+//   std::pmr::vector<sf::Vertex> vertices(&frameMemory);
+class FrameMemory : public std::pmr::memory_resource {
+public:
+    explicit FrameMemory(size_t blockSize = 64 * 1024) : blockSize(blockSize), current(0), offset(0) {
+        blocks.push_back(Block{ std::make_unique<std::byte[]>(blockSize), blockSize });
+    }
+
+    FrameMemory(const FrameMemory&) = delete;
+    FrameMemory& operator=(const FrameMemory&) = delete;
+
+    // Make every allocation since the last reset available again
+    void reset() {
+        current = 0;
+        offset = 0;
+    }
+
+    // Bytes held across all blocks, for sizing the first block
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks) {
+            total += block.size;
+        }
+        return total;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        while (true) {
+            Block& block = blocks[current];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+            std::uintptr_t start = (base + offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            size_t end = static_cast<size_t>(start - base) + bytes;
+            if (end <= block.size) {
+                offset = end;
+                return reinterpret_cast<void*>(start);
+            }
+
+            // Move on to the next block, adding one big enough if this was the last
+            if (++current == blocks.size()) {
+                size_t size = std::max(blockSize, bytes + alignment);
+                blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+            }
+            offset = 0;
+        }
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}  // Reclaimed by reset()
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t current;  // Block allocations come from
+    size_t offset;  // Bytes used in the current block
+};
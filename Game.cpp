@@ -1,143 +1,146 @@
 #include "Game.h"
 #include "Commands.h"
+#include "AllocationCounter.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <random>
 
-Game::Game()
+Game::Game(float tickRate, std::uint32_t seed)
 	: mWindow(sf::VideoMode(800, 800), "Central Defence"),
-	projectilePool(100), // Initialise projectilePool
-	projectileSpawnSystem(projectilePool, 4.f), // Initialise projectileSpanSystem
-	gameManager(projectileSpawnSystem, collisionSystem),  // Initialise gameManager
-	healthSystem(projectilePool, gameManager),  // Initialise healthSystem
-	collisionSystem(projectilePool, gameManager)  // Initialise collisionSystem
+	simulation(Arena{ static_cast<float>(mWindow.getSize().x), static_cast<float>(mWindow.getSize().y) },
+		JobScheduler::defaultWorkerCount(), seed),
+	tickLength(1.f / tickRate)
 {
-	initialisePlayer();
-	initialiseBase();
-
-	// Update player minimum rotation radius
-	Rotation* playerRotation = componentManager.getComponent<Rotation>(playerEntity);
-	playerRotation->minRadius =
-		dynamic_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(baseEntity)->shape)->getRadius()
-		+ dynamic_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(playerEntity)->shape)->getRadius();
+#ifdef _WIN32
+	debug.loadOverlayFont("C:/Windows/Fonts/consola.ttf");  // Labels for the profile overlay, if available
+#endif
 }
 
-void Game::run() {
-	const float desiredFPS = 60.f;
-	const float timePerFrame = 1.f / desiredFPS;
-
-	sf::Clock clock;
+std::uint32_t Game::randomSeed() {
+	std::random_device device;
+	return device();
+}
 
-	while (mWindow.isOpen()) {
-		gameLoop(clock, timePerFrame);
+bool Game::recordInput(const char* path) {
+	const Arena& arena = simulation.getArena();
+	if (!inputRecorder.open(path, SessionHeader{ simulation.getSeed(), arena.width, arena.height, tickLength })) {
+		LOG_WARNING("Can't record input to {}", path);
+		return false;
 	}
+	LOG_INFO("Recording input to {}, seed {}", path, simulation.getSeed());
+	return true;
 }
 
-void Game::gameLoop(sf::Clock& clock, float timePerFrame) {
-	sf::Time elapsed = clock.restart();
-	float deltaTime = elapsed.asSeconds();
-
-	processInput();
-	update(deltaTime);
-	render();
+void Game::run() {
+	sf::Clock clock;
+	sf::Time lastFrame = clock.getElapsedTime();
+	float accumulator = 0.f;  // Real time not yet simulated
 
-	float frameTime = clock.getElapsedTime().asSeconds();
+	while (mWindow.isOpen()) {
+		gameLoop(clock, lastFrame, accumulator);
+	}
 
-	if (frameTime < timePerFrame) {
-		sf::sleep(sf::seconds(timePerFrame - frameTime)); // Wait for full frame time before next loop
+	if (inputRecorder.isOpen()) {
+		// The state a replay of the recording should finish in
+		LOG_INFO("Recorded {} ticks, final state hash {}", inputRecorder.getTicks(), simulation.stateHash());
+		inputRecorder.close();
 	}
 }
 
-void Game::processInput() {
-	RotateClockwiseCommand rotateClockwise;
-	RotateAntiClockwiseCommand rotateAntiClockwise;
-	ChangeRotationDirectionCommand changeRotationDirection;
-	IncreaseRadiusCommand increaseRadius;
-	DecreaseRadiusCommand decreaseRadius;
-
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
-		rotateClockwise.execute(componentManager, playerEntity);
-	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
-		rotateAntiClockwise.execute(componentManager, playerEntity);
-	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) {
-		increaseRadius.execute(componentManager, playerEntity);
-	}
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
-		decreaseRadius.execute(componentManager, playerEntity);
+void Game::gameLoop(sf::Clock& clock, sf::Time& lastFrame, float& accumulator) {
+	const float maxFrameTime = 0.25f;  // After a stall, drop time rather than run a burst of ticks to catch up
+
+	frameMemory.reset();
+	const ObjectPool& projectilePool = simulation.getProjectilePool();
+	size_t peakBefore = projectilePool.getPeakActive();
+	size_t growthBefore = projectilePool.getGrowthCount();
+
+	// Read the clock without restarting it, so very short frames don't each lose a rounding error
+	sf::Time now = clock.getElapsedTime();
+	accumulator += std::min((now - lastFrame).asSeconds(), maxFrameTime);
+	lastFrame = now;
+
+	pollEvents();
+
+	// Counted from here, on this thread only: SFML's event handling allocates in the platform
+	// layer, as does saving a trace from F4, and neither is the game's steady state
+	size_t allocationsBefore = AllocationCounter::count();
+	size_t ticks = 0;
+	while (accumulator >= tickLength) {
+		processInput();  // Held keys act once per tick, whatever the frame rate
+		update(tickLength);
+		accumulator -= tickLength;
+		++ticks;
 	}
+	render(accumulator / tickLength);
+	Profiler::collect();
+
+	// A new peak of live projectiles is where pools, views and collision buffers grow
+	bool storageGrew = projectilePool.getPeakActive() != peakBefore || projectilePool.getGrowthCount() != growthBefore;
+	debug.checkFrameAllocations(AllocationCounter::count() - allocationsBefore, ticks, storageGrew);
+}
 
+void Game::pollEvents() {
 	sf::Event event;
 	while (mWindow.pollEvent(event)) {
 		if (event.type == sf::Event::Closed)
 			mWindow.close();
+
+		// F3 shows the profile overlay, F4 saves the recorded zones for chrome://tracing
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+			debug.toggleProfile();
+		}
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4) {
+			if (Profiler::writeChromeTrace("central_defence_trace.json")) {
+				LOG_INFO("Profile written to central_defence_trace.json");
+			}
+			else {
+				LOG_WARNING("No profile written; build with CENTRAL_DEFENCE_PROFILER to record one");
+			}
+		}
 	}
 }
 
+void Game::processInput() {
+	std::uint8_t input = 0;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) input |= PlayerInput::RotateClockwise;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) input |= PlayerInput::RotateAntiClockwise;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) input |= PlayerInput::IncreaseRadius;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) input |= PlayerInput::DecreaseRadius;
+
+	inputRecorder.record(input);
+	PlayerInput::execute(input, simulation.getComponentManager(), simulation.getPlayerEntity());
+}
+
 void Game::update(float deltaTime) {
-	movementSystem.update(componentManager, deltaTime);
-	rotationSystem.update(componentManager, deltaTime);
-	collisionSystem.update(componentManager, mWindow);
-	projectileSpawnSystem.update(componentManager, mWindow, deltaTime);
-	healthSystem.update(componentManager, mWindow);
+	PROFILE_ZONE("update");  // Each system in the tick has a zone of its own, from SystemGraph
+	simulation.update(deltaTime);
 }
 
-void Game::render() {
+void Game::render(float alpha) {
+	PROFILE_ZONE("render");
 	mWindow.clear();
 	updateBaseColour();
-	renderSystem.render(componentManager, mWindow);
-	debug.renderColliders(componentManager, mWindow);
-	mWindow.display();
-}
-
-void Game::initialisePlayer() {
-	Entity player = Entity(0);
-	componentManager.addComponent<Transform>(player.getId(), Transform(0.f, 0.f, 0.f));
-	sf::CircleShape* playerShape = new sf::CircleShape(10.f);
-	playerShape->setFillColor(sf::Color::Cyan);
-	componentManager.addComponent<Renderable>(player.getId(), Renderable(playerShape, nullptr));
-	float x = mWindow.getSize().x / 2 - playerShape->getRadius();
-	float y = mWindow.getSize().y / 2 - playerShape->getRadius();
-	float maxRadius = mWindow.getSize().x / 2 - playerShape->getRadius();
-	componentManager.addComponent<Rotation>(player.getId(), Rotation(0.f, 80.f, true, x, y, mWindow.getSize().x / 4, maxRadius, 1.f));
-	componentManager.addComponent<BoxCollider>(player.getId(), BoxCollider(x, y, playerShape->getRadius() * 2, playerShape->getRadius() * 2));
-	playerEntity = player.getId();
-}
-
-void Game::initialiseBase() {
-	Entity base = Entity(1);
-	sf::CircleShape* baseShape = new sf::CircleShape(100.f);
-	baseShape->setFillColor(sf::Color::White);
-	componentManager.addComponent<Renderable>(base.getId(), Renderable(baseShape, nullptr));
-	float centerX = mWindow.getSize().x / 2 - baseShape->getRadius();
-	float centerY = mWindow.getSize().y / 2 - baseShape->getRadius();
-	componentManager.addComponent<Transform>(base.getId(), Transform(centerX, centerY, 0.f));
-	componentManager.addComponent<CircleCollider>(base.getId(), CircleCollider(centerX + baseShape->getRadius(), centerY + baseShape->getRadius(), baseShape->getRadius()));
-	componentManager.addComponent<Health>(base.getId(), Health(4));  // Add Health component with 4 max health
-	baseEntity = base.getId();
-}
-
-void Game::initialiseProjectile(float startX, float startY, float velocityX, float velocityY) {
-	// Get a projectile from the pool
-	Entity* projectile = projectilePool.acquire();
-	if (!projectile) return;  // If no available projectile, do nothing
-
-	// Clear existing components
-	componentManager.removeComponent<Transform>(projectile->getId());
-	componentManager.removeComponent<Velocity>(projectile->getId());
-	componentManager.removeComponent<Renderable>(projectile->getId());
-	componentManager.removeComponent<BoxCollider>(projectile->getId());
-
-	// Initialize projectile components
-	componentManager.addComponent<Transform>(projectile->getId(), Transform(startX, startY, 0.f));
-	componentManager.addComponent<Velocity>(projectile->getId(), Velocity(velocityX, velocityY));
-
-	sf::CircleShape* shape = new sf::CircleShape(5.f);
-	shape->setFillColor(sf::Color::Red);
-	componentManager.addComponent<Renderable>(projectile->getId(), Renderable(shape));
-
-	componentManager.addComponent<BoxCollider>(projectile->getId(), BoxCollider(startX, startY, shape->getRadius() * 2, shape->getRadius() * 2));
+	{
+		PROFILE_ZONE("render entities");
+		renderSystem.render(simulation.getComponentManager(), mWindow, alpha);
+	}
+	{
+		PROFILE_ZONE("render colliders");
+		debug.renderColliders(simulation.getComponentManager(), mWindow, frameMemory);
+	}
+	debug.renderProfile(simulation.getComponentManager(), mWindow, frameMemory);
+	{
+		PROFILE_ZONE("display");
+		mWindow.display();
+	}
 }
 
 void Game::updateBaseColour() {
+	ComponentManager& componentManager = simulation.getComponentManager();
+	Entity::ID baseEntity = simulation.getBaseEntity();
+
 	// Get base Health
 	Health* baseHealth = componentManager.getComponent<Health>(baseEntity);
 	if (!baseHealth) return;
@@ -151,7 +154,7 @@ void Game::updateBaseColour() {
 	int redIntensity = static_cast<int>((1.f - healthRatio) * 255);
 
 	// Update the base colour
-	sf::CircleShape* baseShape = dynamic_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(baseEntity)->shape);
+	sf::CircleShape* baseShape = static_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(baseEntity)->shape);
 	if (baseShape) {
 		baseShape->setFillColor(sf::Color(255, 255 - redIntensity, 255 - redIntensity));  // Change to a shade of red
 	}
@@ -1,38 +1,43 @@
-#include "Systems.h"
-#include "ObjectPool.h"
+#include "Simulation.h"
 #include "Debug.h"
+#include "FrameMemory.h"
+#include "InputLog.h"
 
+// Runs the simulation on a fixed timestep and renders as often as the window allows. Each frame
+// steps the simulation as many whole ticks as real time calls for, and draws entities blended
+// between the last two ticks, so the tick rate and the frame rate can differ.
 class Game {
 public:
-    Game();
+    explicit Game(float tickRate = 60.f, std::uint32_t seed = randomSeed());
     void run();
 
-    ComponentManager& getComponentManager() { return componentManager; }
+    // Log every tick's input to path, so the headless driver can replay the session. Call before run().
+    bool recordInput(const char* path);
+
+    // A seed from std::random_device, so each session plays out differently
+    static std::uint32_t randomSeed();
+
+    // Simulation ticks per second. Lower it to cut simulation cost; motion stays smooth.
+    void setTickRate(float ticksPerSecond) { tickLength = 1.f / ticksPerSecond; }
+
+    // Cap on rendered frames per second, or 0 to render as fast as possible
+    void setRenderRateLimit(unsigned int framesPerSecond) { mWindow.setFramerateLimit(framesPerSecond); }
+
+    ComponentManager& getComponentManager() { return simulation.getComponentManager(); }
 private:
-    void gameLoop(sf::Clock& clock, float timePerFrame);
+    void gameLoop(sf::Clock& clock, sf::Time& lastFrame, float& accumulator);
+    void pollEvents();
     void processInput();
     void update(float deltaTime);
-    void render(); 
-
-    void initialisePlayer();
-    void initialiseBase();
-    void initialiseProjectile(float startX, float startY, float velocityX, float velocityY);
+    void render(float alpha);
 
     void updateBaseColour();
 
     sf::RenderWindow mWindow;
-    ComponentManager componentManager;
-    MovementSystem movementSystem;
-    RotationSystem rotationSystem;
+    Simulation simulation;
     RenderSystem renderSystem;
-    CollisionSystem collisionSystem;
-    HealthSystem healthSystem;
-    ProjectileSpawnSystem projectileSpawnSystem;
-    GameManager gameManager;
     Debug debug;
-
-    Entity::ID playerEntity;
-    Entity::ID baseEntity;
-
-    ObjectPool projectilePool;
+    InputRecorder inputRecorder;
+    FrameMemory frameMemory;  // Scratch data for the current frame, reset at the top of gameLoop
+    float tickLength;  // Seconds of game time per simulation tick
 };
@@ -0,0 +1,70 @@
+#pragma once
+#include <tuple>
+#include "Entity.h"
+#include "ComponentPool.h"
+
+// Type-erased base so the ComponentManager can tell groups about component changes
+class IGroup {
+public:
+    virtual ~IGroup() = default;
+    virtual void onComponentAdded(Entity::ID entity) = 0;
+    virtual void onComponentRemoving(Entity::ID entity) = 0;  // Called before the pool removes it
+};
+
+// Keeps the entities that have every component in Ts at the front of each Ts pool, in the same
+// order, so the first size() entries of the pools' packed arrays line up row for row the way an
+// archetype chunk's columns do, and a batch kernel can take them straight. Joining and leaving
+// swap entries within the pools, which costs O(1) per pool. A group owns its pools: a pool can
+// belong to one group at most.
+template <typename... Ts>
+class Group : public IGroup {
+public:
+    explicit Group(ComponentPool<Ts>&... componentPools) : pools(&componentPools...), length(0) {
+        // Joining only swaps entities already seen toward the front, so indexing stays valid
+        const std::vector<Entity::ID>& seed = first().entities();
+        for (size_t i = 0; i < seed.size(); ++i) {
+            onComponentAdded(seed[i]);
+        }
+    }
+
+    void onComponentAdded(Entity::ID entity) override {
+        if (contains(entity) || !(std::get<ComponentPool<Ts>*>(pools)->has(entity) && ...)) return;
+
+        (moveTo<Ts>(entity, static_cast<unsigned int>(length)), ...);
+        ++length;
+    }
+
+    void onComponentRemoving(Entity::ID entity) override {
+        if (!contains(entity)) return;
+
+        // Swap the last member into the freed row, leaving the entity just past the group
+        --length;
+        (moveTo<Ts>(entity, static_cast<unsigned int>(length)), ...);
+    }
+
+    bool contains(Entity::ID entity) const {
+        return first().has(entity) && first().indexOf(entity) < length;
+    }
+
+    size_t size() const { return length; }
+
+    // Packed array of one of the components; entries [0, size()) are the group's members
+    template <typename T>
+    T* data() { return std::get<ComponentPool<T>*>(pools)->components().data(); }
+
+    const Entity::ID* entities() const { return first().entities().data(); }
+
+private:
+    using First = typename std::tuple_element<0, std::tuple<Ts...>>::type;
+
+    const ComponentPool<First>& first() const { return *std::get<ComponentPool<First>*>(pools); }
+
+    template <typename T>
+    void moveTo(Entity::ID entity, unsigned int index) {
+        ComponentPool<T>* pool = std::get<ComponentPool<T>*>(pools);
+        pool->swapEntries(pool->indexOf(entity), index);
+    }
+
+    std::tuple<ComponentPool<Ts>*...> pools;
+    size_t length;  // Members, all at the front of every pool
+};
@@ -0,0 +1,98 @@
+#include "InputLog.h"
+#include <cstring>
+
+namespace {
+
+const char Magic[4] = { 'C', 'D', 'I', '1' };
+
+}
+
+bool InputRecorder::open(const char* path, const SessionHeader& header) {
+	close();
+	file = std::fopen(path, "wb");
+	if (!file) return false;
+	std::setvbuf(file, buffer, _IOFBF, sizeof(buffer));
+
+	std::fwrite(Magic, sizeof(Magic), 1, file);
+	std::fwrite(&header, sizeof(header), 1, file);
+	ticks = 0;
+	lastEntry = 0;
+	return true;
+}
+
+void InputRecorder::record(std::uint8_t input) {
+	if (!file) return;
+
+	if (input) {
+		writeEntry(ticks - lastEntry, input);
+		lastEntry = ticks + 1;
+	}
+	++ticks;
+}
+
+void InputRecorder::close() {
+	if (!file) return;
+
+	writeEntry(ticks - lastEntry, 0);
+	std::fclose(file);
+	file = nullptr;
+}
+
+// gap is the number of idle ticks before this one
+void InputRecorder::writeEntry(std::uint64_t gap, std::uint8_t input) {
+	while (gap >= 0x80) {
+		std::fputc(static_cast<int>((gap & 0x7F) | 0x80), file);
+		gap >>= 7;
+	}
+	std::fputc(static_cast<int>(gap), file);
+	std::fputc(input, file);
+}
+
+InputPlayback::~InputPlayback() {
+	if (file) std::fclose(file);
+}
+
+bool InputPlayback::open(const char* path) {
+	if (file) std::fclose(file);
+	file = std::fopen(path, "rb");
+	if (!file) return false;
+
+	char magic[sizeof(Magic)];
+	if (std::fread(magic, sizeof(magic), 1, file) != 1 || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+		|| std::fread(&header, sizeof(header), 1, file) != 1) {
+		std::fclose(file);
+		file = nullptr;
+		return false;
+	}
+
+	ended = false;
+	readEntry();
+	return true;
+}
+
+std::uint8_t InputPlayback::next() {
+	if (ticksToEntry > 0) {
+		--ticksToEntry;
+		return 0;
+	}
+	if (ended) return 0;
+
+	std::uint8_t input = pendingInput;
+	readEntry();
+	return input;
+}
+
+void InputPlayback::readEntry() {
+	std::uint64_t gap = 0;
+	int c;
+	for (int shift = 0; (c = std::fgetc(file)) != EOF && shift < 64; shift += 7) {
+		gap |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+		if (!(c & 0x80)) break;
+	}
+	int input = c == EOF ? EOF : std::fgetc(file);
+
+	// A log cut short, say by a crash, ends at the last whole entry
+	ticksToEntry = input == EOF ? 0 : gap;
+	pendingInput = input == EOF ? 0 : static_cast<std::uint8_t>(input);
+	ended = pendingInput == 0;
+}
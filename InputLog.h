@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// Everything besides player input that a replay needs to repeat a session exactly
+struct SessionHeader {
+    std::uint32_t seed;  // Simulation's random seed
+    float arenaWidth;
+    float arenaHeight;
+    float tickLength;  // Seconds per simulation tick
+};
+
+// Binary input log: a header, then one entry per tick that had input, holding the number of
+// ticks since the previous entry (LEB128 varint) and the tick's PlayerInput bits. An entry with
+// no input bits marks the end. Idle stretches cost nothing and a busy tick costs two bytes.
+//
+// Writes go through stdio's buffer, so recording a tick is a memory write, not a syscall.
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder() { close(); }
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    // Start a log at path, replacing any file there. False if it can't be created.
+    bool open(const char* path, const SessionHeader& header);
+
+    // Call once per tick, before the tick runs, with the input it gets
+    void record(std::uint8_t input);
+
+    // Write the end marker and close; also done on destruction
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+    std::uint64_t getTicks() const { return ticks; }
+
+private:
+    void writeEntry(std::uint64_t gap, std::uint8_t input);
+
+    std::FILE* file = nullptr;
+    char buffer[4096];  // stdio's buffer, given up front so the first write of a session doesn't allocate one
+    std::uint64_t ticks = 0;
+    std::uint64_t lastEntry = 0;  // Tick count at the previous entry
+};
+
+// Reads an InputRecorder log back a tick at a time
+class InputPlayback {
+public:
+    InputPlayback() = default;
+    ~InputPlayback();
+
+    InputPlayback(const InputPlayback&) = delete;
+    InputPlayback& operator=(const InputPlayback&) = delete;
+
+    // False if the file is missing or doesn't start with a session header
+    bool open(const char* path);
+
+    const SessionHeader& getHeader() const { return header; }
+
+    // True once every recorded tick has been returned by next()
+    bool finished() const { return ended && ticksToEntry == 0; }
+
+    // Input for the next tick
+    std::uint8_t next();
+
+private:
+    void readEntry();
+
+    std::FILE* file = nullptr;
+    SessionHeader header{};
+    std::uint64_t ticksToEntry = 0;  // Ticks until pendingInput applies
+    std::uint8_t pendingInput = 0;
+    bool ended = false;
+};
@@ -0,0 +1,124 @@
+#include "JobScheduler.h"
+#include "Log.h"
+#include "Profiler.h"
+
+// Which scheduler's worker the current thread is, if any, and which queue it owns
+static thread_local const JobScheduler* workerOf = nullptr;
+static thread_local size_t workerQueue = 0;
+
+void JobScheduler::JobQueue::push(const Job& job) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (count == jobs.size()) {
+		// Unroll the ring into a buffer twice the size
+		std::vector<Job> grown(jobs.size() * 2);
+		for (size_t i = 0; i < count; ++i) {
+			grown[i] = jobs[(head + i) % jobs.size()];
+		}
+		jobs.swap(grown);
+		head = 0;
+	}
+	jobs[(head + count) % jobs.size()] = job;
+	++count;
+}
+
+bool JobScheduler::JobQueue::pop(Job& job) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (count == 0) return false;
+
+	--count;
+	job = jobs[(head + count) % jobs.size()];
+	return true;
+}
+
+bool JobScheduler::JobQueue::steal(Job& job) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (count == 0) return false;
+
+	job = jobs[head];
+	head = (head + 1) % jobs.size();
+	--count;
+	return true;
+}
+
+JobScheduler::JobScheduler(unsigned int workers) : queued(0), stopping(false) {
+	// The creating thread runs jobs too, from wait()
+	Log::registerThread();
+	Profiler::registerThread();
+	for (unsigned int i = 0; i <= workers; ++i) {
+		queues.push_back(std::make_unique<JobQueue>());
+	}
+	for (unsigned int i = 1; i <= workers; ++i) {
+		threads.emplace_back(&JobScheduler::workerLoop, this, i);
+	}
+}
+
+JobScheduler::~JobScheduler() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+unsigned int JobScheduler::defaultWorkerCount() {
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobScheduler::submit(const Job& job) {
+	queued.fetch_add(1, std::memory_order_relaxed);  // Before the push, so taking the job never finds queued at 0
+	queues[ownQueue()]->push(job);
+
+	// Taking the lock orders this submit against a worker checking queued before it sleeps
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wakeUp.notify_one();
+}
+
+size_t JobScheduler::ownQueue() const {
+	return workerOf == this ? workerQueue : 0;
+}
+
+bool JobScheduler::runOne() {
+	size_t self = ownQueue();
+	Job job;
+	bool found = queues[self]->pop(job);
+	for (size_t i = 1; !found && i < queues.size(); ++i) {
+		found = queues[(self + i) % queues.size()]->steal(job);
+	}
+	if (!found) return false;
+
+	queued.fetch_sub(1, std::memory_order_relaxed);
+	job.run(job.context, job.index);
+	return true;
+}
+
+void JobScheduler::workerLoop(size_t self) {
+	workerOf = this;
+	workerQueue = self;
+	// Before taking jobs, so a job's first message or zone doesn't allocate
+	Log::registerThread();
+	Profiler::registerThread();
+
+	const int spinsBeforeSleeping = 64;  // Jobs often come in bursts, so look again a few times first
+	while (true) {
+		int spins = 0;
+		while (spins < spinsBeforeSleeping) {
+			if (runOne()) {
+				spins = 0;
+			}
+			else {
+				++spins;
+				std::this_thread::yield();
+			}
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeUp.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+		if (stopping) return;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A unit of work: a plain function pointer and its arguments, so queuing one never allocates
+struct Job {
+    void (*run)(void* context, size_t index);
+    void* context;
+    size_t index;
+};
+
+// Fixed set of worker threads with a job queue each. A thread pushes and pops at the back of its
+// own queue and, once that is empty, steals from the front of another thread's, so work spreads
+// out without one shared queue that every thread contends on. The thread calling wait() takes
+// jobs too, so a scheduler with no workers runs everything on the caller.
+// Every thread that runs jobs has its log and profiler rings made up front, so logging or
+// timing a zone from a job never allocates.
+class JobScheduler {
+public:
+    // workers is the number of threads besides the caller's
+    explicit JobScheduler(unsigned int workers = defaultWorkerCount());
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    // Queue a job. Safe to call from inside a running job.
+    void submit(const Job& job);
+
+    // Run jobs on the calling thread until done() returns true
+    template <typename Done>
+    void wait(Done done) {
+        while (!done()) {
+            if (!runOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Call body(begin, end) over [0, count) in ranges of grain items, spread across the workers
+    // and the calling thread, and return once every range is done. A single range runs inline.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body body) {
+        size_t ranges = (count + grain - 1) / grain;
+        if (ranges <= 1 || threads.empty()) {
+            if (count > 0) body(size_t(0), count);
+            return;
+        }
+
+        ParallelFor<Body> work{ &body, count, grain, { 0 } };
+        for (size_t i = 0; i < ranges; ++i) {
+            submit(Job{ &ParallelFor<Body>::run, &work, i });
+        }
+        wait([&] { return work.finished.load(std::memory_order_acquire) == ranges; });
+    }
+
+    // Range size for parallelFor that gives every thread a few ranges to balance between, rounded
+    // up to a multiple of alignment items and never below minimum, so small counts stay serial
+    size_t grainFor(size_t count, size_t alignment, size_t minimum) const {
+        size_t grain = count / ((threads.size() + 1) * 4) + 1;
+        grain = std::max(grain, minimum);
+        return (grain + alignment - 1) / alignment * alignment;
+    }
+
+    unsigned int workerCount() const { return static_cast<unsigned int>(threads.size()); }
+
+    // One worker per hardware thread, leaving one for the thread that submits
+    static unsigned int defaultWorkerCount();
+
+private:
+    // One parallelFor call, shared by its range jobs; lives on the calling thread's stack
+    template <typename Body>
+    struct ParallelFor {
+        Body* body;
+        size_t count;
+        size_t grain;
+        std::atomic<size_t> finished;
+
+        static void run(void* context, size_t index) {
+            ParallelFor& work = *static_cast<ParallelFor*>(context);
+            size_t begin = index * work.grain;
+            (*work.body)(begin, std::min(begin + work.grain, work.count));
+            work.finished.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    // Ring buffer of jobs behind a mutex. Only grows, so a steady load doesn't allocate.
+    class JobQueue {
+    public:
+        JobQueue() : jobs(64), head(0), count(0) {}
+
+        void push(const Job& job);
+        bool pop(Job& job);  // Newest first, for the owning thread
+        bool steal(Job& job);  // Oldest first, for every other thread
+
+    private:
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        size_t head;
+        size_t count;
+    };
+
+    void workerLoop(size_t self);
+    bool runOne();
+    size_t ownQueue() const;
+
+    std::vector<std::unique_ptr<JobQueue>> queues;  // [0] for threads outside the pool, then one per worker
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued;  // Jobs submitted and not yet taken
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;  // Idle workers wait here for queued to become non-zero
+};
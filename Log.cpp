@@ -0,0 +1,211 @@
+#include "Log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Records from one producing thread. Only the owner pushes and only the drain pops, so the
+// indices are the only shared state. A thread that exits hands its ring back for reuse.
+class Ring {
+public:
+	static constexpr size_t Capacity = 1024;  // Power of two, so an index wraps with a mask
+
+	bool push(const Log::Record& record) {
+		size_t tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - head.load(std::memory_order_acquire) == Capacity) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		records[tail & (Capacity - 1)] = record;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(Log::Record& record) {
+		size_t head = this->head.load(std::memory_order_relaxed);
+		if (head == tail.load(std::memory_order_acquire)) return false;
+
+		record = records[head & (Capacity - 1)];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::atomic<bool> owned{ true };
+	std::atomic<size_t> dropped{ 0 };
+	size_t droppedReported = 0;  // Drain side only
+
+private:
+	std::array<Log::Record, Capacity> records;
+	alignas(64) std::atomic<size_t> head{ 0 };  // Next record to pop, written by the drain
+	alignas(64) std::atomic<size_t> tail{ 0 };  // Next free slot, written by the owner
+};
+
+// Every ring, and the thread that formats their records every few milliseconds
+class Logger {
+public:
+	Logger() : output(&std::cout), unplacedDropped(0), stopping(false), thread(&Logger::drainLoop, this) {
+		// Spares for threads that log without registering, so write() never has to make a ring
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t i = 0; i < SpareRings; ++i) {
+			rings.push_back(std::make_unique<Ring>());
+			rings.back()->owned.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	~Logger() {
+		stopping = true;
+		thread.join();
+		drain();
+	}
+
+	// A spare ring or one left by an exited thread if there is one. Otherwise a new one if grow
+	// is set, or nullptr.
+	Ring* acquireRing(bool grow) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const std::unique_ptr<Ring>& ring : rings) {
+			bool owned = false;
+			if (ring->owned.compare_exchange_strong(owned, true)) return ring.get();
+		}
+		if (!grow) return nullptr;
+
+		rings.push_back(std::make_unique<Ring>());
+		return rings.back().get();
+	}
+
+	// A message from a thread that found no ring to take
+	void dropUnplaced() { unplacedDropped.fetch_add(1, std::memory_order_relaxed); }
+
+	void drain() {
+		std::lock_guard<std::mutex> lock(mutex);
+		Log::Record record;
+		for (const std::unique_ptr<Ring>& ring : rings) {
+			while (ring->pop(record)) {
+				print(record);
+			}
+
+			size_t dropped = ring->dropped.load(std::memory_order_relaxed);
+			if (dropped != ring->droppedReported && output) {
+				*output << "[log] " << dropped - ring->droppedReported << " messages dropped, ring full\n";
+				ring->droppedReported = dropped;
+			}
+		}
+		size_t unplaced = unplacedDropped.load(std::memory_order_relaxed);
+		if (unplaced != unplacedReported && output) {
+			*output << "[log] " << unplaced - unplacedReported << " messages dropped, no ring for their thread\n";
+			unplacedReported = unplaced;
+		}
+		if (output) output->flush();
+	}
+
+	void setOutput(std::ostream* stream) {
+		std::lock_guard<std::mutex> lock(mutex);
+		output = stream;
+	}
+
+private:
+	void drainLoop() {
+		while (!stopping) {
+			drain();
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+
+	// Fills a fixed buffer, so formatting never allocates
+	void print(const Log::Record& record) {
+		if (!output) return;
+
+		static const char* const levelNames[] = { "debug", "info", "warning", "error" };
+		char line[512];
+		size_t length = std::snprintf(line, sizeof(line), "[%s] ", levelNames[static_cast<int>(record.level)]);
+
+		size_t next = 0;
+		for (const char* c = record.format; *c && length < sizeof(line) - 1; ++c) {
+			if (c[0] == '{' && c[1] == '}' && next < record.count) {
+				length += formatArg(record.args[next++], line + length, sizeof(line) - length);
+				length = std::min(length, sizeof(line) - 1);
+				++c;
+			}
+			else {
+				line[length++] = *c;
+			}
+		}
+		line[length++] = '\n';
+		output->write(line, static_cast<std::streamsize>(length));
+	}
+
+	static size_t formatArg(const Log::Arg& arg, char* buffer, size_t size) {
+		int written = 0;
+		switch (arg.type) {
+		case Log::Arg::Type::Signed: written = std::snprintf(buffer, size, "%lld", arg.i); break;
+		case Log::Arg::Type::Unsigned: written = std::snprintf(buffer, size, "%llu", arg.u); break;
+		case Log::Arg::Type::Float: written = std::snprintf(buffer, size, "%g", arg.d); break;
+		case Log::Arg::Type::String: written = std::snprintf(buffer, size, "%s", arg.s); break;
+		}
+		return written > 0 ? static_cast<size_t>(written) : 0;
+	}
+
+	static constexpr size_t SpareRings = 2;
+
+	std::mutex mutex;  // Guards rings and output; producers only take it to get their ring
+	std::vector<std::unique_ptr<Ring>> rings;
+	std::ostream* output;
+	std::atomic<size_t> unplacedDropped;
+	size_t unplacedReported = 0;  // Drain side only
+	std::atomic<bool> stopping;
+	std::thread thread;
+};
+
+Logger& logger() {
+	static Logger instance;
+	return instance;
+}
+
+// The calling thread's ring, returned to the logger when the thread exits
+struct RingHandle {
+	Ring* ring = nullptr;
+
+	~RingHandle() {
+		if (ring) ring->owned.store(false, std::memory_order_release);
+	}
+};
+
+thread_local RingHandle threadRing;
+
+}
+
+namespace Log {
+
+void registerThread() {
+	if (!threadRing.ring) {
+		threadRing.ring = logger().acquireRing(true);
+	}
+}
+
+void write(const Record& record) {
+	if (!threadRing.ring) {
+		threadRing.ring = logger().acquireRing(false);  // Never allocates; see registerThread
+		if (!threadRing.ring) {
+			logger().dropUnplaced();
+			return;
+		}
+	}
+	threadRing.ring->push(record);
+}
+
+void flush() {
+	logger().drain();
+}
+
+void setOutput(std::ostream* output) {
+	logger().setOutput(output);
+}
+
+}
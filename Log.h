@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+
+// Levels for CENTRAL_DEFENCE_LOG_LEVEL. Messages below the chosen level compile out entirely,
+// arguments included. Defaults to debug, or info when NDEBUG is defined.
+#define CENTRAL_DEFENCE_LOG_DEBUG 0
+#define CENTRAL_DEFENCE_LOG_INFO 1
+#define CENTRAL_DEFENCE_LOG_WARNING 2
+#define CENTRAL_DEFENCE_LOG_ERROR 3
+#define CENTRAL_DEFENCE_LOG_OFF 4
+
+#ifndef CENTRAL_DEFENCE_LOG_LEVEL
+#ifdef NDEBUG
+#define CENTRAL_DEFENCE_LOG_LEVEL CENTRAL_DEFENCE_LOG_INFO
+#else
+#define CENTRAL_DEFENCE_LOG_LEVEL CENTRAL_DEFENCE_LOG_DEBUG
+#endif
+#endif
+
+// Logging that is cheap enough for the frame thread. A call copies the format pointer and its
+// arguments, still binary, into a ring owned by the calling thread and returns; a background
+// thread formats and prints them. Each ring has one producer and one consumer, so neither
+// side takes a lock. When a ring is full the message is dropped and counted rather than
+// stalling the caller.
+//
+// The format is a string literal with {} for each argument. Arguments are numbers or strings
+// that outlive the program, such as other literals, since only the pointer is kept.
+//   LOG_INFO("Damage applied to entity {}: -{} health", entity, damage);
+namespace Log {
+    enum class Level : std::uint8_t { Debug, Info, Warning, Error };
+
+    // One argument, stored by value until the background thread formats it
+    struct Arg {
+        enum class Type : std::uint8_t { Signed, Unsigned, Float, String };
+
+        union {
+            long long i;
+            unsigned long long u;
+            double d;
+            const char* s;
+        };
+        Type type;
+
+        Arg() : i(0), type(Type::Signed) {}
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+        Arg(T value) : i(value), type(Type::Signed) {}
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, int>::type = 0>
+        Arg(T value) : u(value), type(Type::Unsigned) {}
+
+        Arg(double value) : d(value), type(Type::Float) {}
+        Arg(const char* value) : s(value), type(Type::String) {}
+    };
+
+    constexpr size_t MaxArgs = 4;
+
+    struct Record {
+        const char* format;
+        Level level;
+        std::uint8_t count;
+        Arg args[MaxArgs];
+    };
+
+    // Give the calling thread its ring now, allocating one if none is free, rather than on its
+    // first message. JobScheduler does this for its workers and for the thread that creates it;
+    // any other thread that logs from a frame should call it before the game loop starts.
+    void registerThread();
+
+    // Queue a record on the calling thread's ring; use the LOG_ macros rather than calling this.
+    // Never allocates: a thread that hasn't registered takes a spare ring, or drops the message
+    // and has it counted when there is none.
+    void write(const Record& record);
+
+    template <typename... Args>
+    void write(Level level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MaxArgs, "Too many log arguments");
+        write(Record{ format, level, static_cast<std::uint8_t>(sizeof...(Args)), { Arg(args)... } });
+    }
+
+    // Format and print everything queued so far before returning
+    void flush();
+
+    // Where the background thread prints; std::cout by default, nullptr discards
+    void setOutput(std::ostream* output);
+}
+
+#if CENTRAL_DEFENCE_LOG_LEVEL <= CENTRAL_DEFENCE_LOG_DEBUG
+#define LOG_DEBUG(...) ::Log::write(::Log::Level::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if CENTRAL_DEFENCE_LOG_LEVEL <= CENTRAL_DEFENCE_LOG_INFO
+#define LOG_INFO(...) ::Log::write(::Log::Level::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if CENTRAL_DEFENCE_LOG_LEVEL <= CENTRAL_DEFENCE_LOG_WARNING
+#define LOG_WARNING(...) ::Log::write(::Log::Level::Warning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void)0)
+#endif
+
+#if CENTRAL_DEFENCE_LOG_LEVEL <= CENTRAL_DEFENCE_LOG_ERROR
+#define LOG_ERROR(...) ::Log::write(::Log::Level::Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
@@ -0,0 +1,87 @@
+#include "MovementKernels.h"
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MOVEMENT_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOVEMENT_KERNELS_SSE2
+#endif
+
+// The vector paths move (x, y), (dx, dy) and (left, top) as 64-bit pairs
+static_assert(sizeof(Velocity) == 2 * sizeof(float), "Velocities must pack as (dx, dy) pairs");
+static_assert(offsetof(Transform, y) == offsetof(Transform, x) + sizeof(float), "Transform x and y must be adjacent");
+static_assert(sizeof(sf::FloatRect) == 4 * sizeof(float), "Box bounds must be four packed floats");
+
+namespace MovementKernels {
+
+void integrateScalar(const Velocity* velocities, Transform* transforms, BoxCollider* boxes, size_t begin, size_t count, float deltaTime) {
+	for (size_t i = begin; i < count; ++i) {
+		transforms[i].x += velocities[i].dx * deltaTime;
+		transforms[i].y += velocities[i].dy * deltaTime;
+
+		if (boxes) {
+			boxes[i].bounds.left = transforms[i].x;
+			boxes[i].bounds.top = transforms[i].y;
+		}
+	}
+}
+
+#if defined(MOVEMENT_KERNELS_AVX2) || defined(MOVEMENT_KERNELS_SSE2)
+// (x, y) of two entities in one register, low half first
+static __m128 loadPositions(const Transform* transforms) {
+	__m128 positions = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&transforms[0].x));
+	return _mm_loadh_pi(positions, reinterpret_cast<const __m64*>(&transforms[1].x));
+}
+
+static void storePositions(Transform* transforms, BoxCollider* boxes, __m128 positions) {
+	_mm_storel_pi(reinterpret_cast<__m64*>(&transforms[0].x), positions);
+	_mm_storeh_pi(reinterpret_cast<__m64*>(&transforms[1].x), positions);
+	if (boxes) {
+		_mm_storel_pi(reinterpret_cast<__m64*>(&boxes[0].bounds.left), positions);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(&boxes[1].bounds.left), positions);
+	}
+}
+#endif
+
+void integrate(const Velocity* velocities, Transform* transforms, BoxCollider* boxes, size_t count, float deltaTime) {
+	size_t i = 0;
+
+#if defined(MOVEMENT_KERNELS_AVX2)
+	const __m256 step = _mm256_set1_ps(deltaTime);
+
+	for (; i + 4 <= count; i += 4) {
+		__m256 velocity = _mm256_loadu_ps(&velocities[i].dx);  // Four (dx, dy) pairs are contiguous
+		__m256 positions = _mm256_insertf128_ps(_mm256_castps128_ps256(loadPositions(&transforms[i])), loadPositions(&transforms[i + 2]), 1);
+
+		positions = _mm256_add_ps(positions, _mm256_mul_ps(velocity, step));
+
+		storePositions(&transforms[i], boxes ? &boxes[i] : nullptr, _mm256_castps256_ps128(positions));
+		storePositions(&transforms[i + 2], boxes ? &boxes[i + 2] : nullptr, _mm256_extractf128_ps(positions, 1));
+	}
+#elif defined(MOVEMENT_KERNELS_SSE2)
+	const __m128 step = _mm_set1_ps(deltaTime);
+
+	for (; i + 2 <= count; i += 2) {
+		__m128 velocity = _mm_loadu_ps(&velocities[i].dx);  // Two (dx, dy) pairs are contiguous
+		__m128 positions = _mm_add_ps(loadPositions(&transforms[i]), _mm_mul_ps(velocity, step));
+
+		storePositions(&transforms[i], boxes ? &boxes[i] : nullptr, positions);
+	}
+#endif
+
+	integrateScalar(velocities, transforms, boxes, i, count, deltaTime);
+}
+
+const char* instructionSet() {
+#if defined(MOVEMENT_KERNELS_AVX2)
+	return "AVX2";
+#elif defined(MOVEMENT_KERNELS_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+}
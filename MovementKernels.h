@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include "Components.h"
+
+// Batched movement over row-aligned component arrays, as an archetype chunk or a sparse-set
+// Group stores them: velocities[i], transforms[i] and boxes[i] belong to the same entity. Each
+// entity's position moves by velocity * deltaTime and, when boxes is given, the box's left/top
+// take the new position in the same pass, so the collider sync doesn't have to sweep the
+// entities again. Components are stored as structs, so a vector register holds the (x, y) pairs
+// of several entities: four with AVX2, two with SSE2, one at a time otherwise. The vector width
+// is chosen at build time, and every path evaluates the same expressions as the scalar loop.
+namespace MovementKernels {
+    void integrate(const Velocity* velocities, Transform* transforms, BoxCollider* boxes, size_t count, float deltaTime);
+
+    // Portable version, also used for the tail the vector loops leave over
+    void integrateScalar(const Velocity* velocities, Transform* transforms, BoxCollider* boxes, size_t begin, size_t count, float deltaTime);
+
+    // "AVX2", "SSE2" or "scalar"
+    const char* instructionSet();
+}
@@ -1,51 +1,138 @@
 #pragma once
 #include <vector>
 #include <functional>
+#include <algorithm>
 #include "Entity.h"
 
+// Recyclable entities, allocated in fixed-size chunks. When every slot is taken the pool adds a
+// chunk, up to a high-water mark, and existing chunks never move, so Entity* pointers stay valid.
+// Free slots form an intrusive singly linked list, so acquire and release are O(1), and active
+// slots are kept in a dense list for iteration.
+// Releasing a slot bumps its generation, so IDs handed out before the release go stale.
 class ObjectPool {
 public:
-    ObjectPool(size_t size) : nextAvailableID(2) {  // Initialize nextAvailableID as 2 (since player is 0 and base is 1)
-        entities.reserve(size);  // Reserve memory for entities
-        for (size_t i = 0; i < size; ++i) {
-            entities.emplace_back(Entity(nextAvailableID++));  // Create entities
-            entities[i].inUse = false;  // Initialize all entities as not in use
-        }
+    static constexpr size_t MaxCapacity = Entity::IndexMask + 1 - 2;  // Every slot index an ID can hold
+
+    // chunkSize entities are created up front and added each time the pool runs dry;
+    // acquire() fails once highWaterMark entities are in use
+    explicit ObjectPool(size_t chunkSize, size_t highWaterMark = MaxCapacity)
+        : chunkSize(std::max<size_t>(chunkSize, 1)), highWaterMark(std::min(highWaterMark, MaxCapacity)),
+          nextAvailableID(2), freeHead(npos), growthCount(0), exhaustionCount(0), peakActive(0) {  // Initialize nextAvailableID as 2 (since player is 0 and base is 1)
+        grow();
     }
 
-    // Get an inactive entity from the pool
+    // Get an inactive entity from the pool, growing it if needed.
+    // Returns nullptr, and counts an exhaustion, only at the high-water mark.
     Entity* acquire() {
-        for (auto& entity : entities) {
-            if (!entity.inUse) {
-                entity.inUse = true;  // Mark the entity as in use
-                return &entity;
-            }
+        if (freeHead == npos && !grow()) {
+            ++exhaustionCount;
+            return nullptr;
         }
-        return nullptr;
+
+        unsigned int slot = freeHead;
+        freeHead = links[slot];
+
+        links[slot] = static_cast<unsigned int>(active.size());
+        active.push_back(slot);
+        peakActive = std::max(peakActive, active.size());
+
+        Entity& entity = at(slot);
+        entity.inUse = true;  // Mark the entity as in use
+        return &entity;
     }
 
-    // Release entity to pool
-    void release(Entity::ID entityId) {
-        if (entityId >= 2 && entityId < nextAvailableID) {  // Ensure valid ID range
-            entities[entityId - 2].inUse = false;
-        }
+    // Release entity to pool. Stale or foreign IDs are ignored, and false is returned.
+    bool release(Entity::ID entityId) {
+        Entity* entity = find(entityId);
+        if (!entity) return false;
+
+        unsigned int slot = Entity::indexOf(entityId) - firstID;
+
+        // Swap the last active slot into this one's place
+        unsigned int position = links[slot];
+        unsigned int last = active.back();
+        active[position] = last;
+        links[last] = position;
+        active.pop_back();
+
+        links[slot] = freeHead;
+        freeHead = slot;
+
+        entity->inUse = false;
+        Entity::ID generation = Entity::generationOf(entity->id);
+        entity->id = Entity::makeId(Entity::indexOf(entity->id), generation < Entity::MaxGeneration ? generation + 1 : 0);
+        return true;
+    }
+
+    // The active entity an ID refers to, or nullptr if it was released since or isn't from this pool
+    Entity* find(Entity::ID entityId) {
+        Entity::ID index = Entity::indexOf(entityId);
+        if (index < firstID || index >= nextAvailableID) return nullptr;
+
+        Entity& entity = at(index - firstID);
+        return (entity.inUse && entity.id == entityId) ? &entity : nullptr;
     }
 
-    // Iterate over active entities
+    bool isValid(Entity::ID entityId) {
+        return find(entityId) != nullptr;
+    }
+
+    // Iterate over active entities. func must not release entities.
     void forEachActive(std::function<void(Entity&)> func) {
-        for (auto& entity : entities) {
-            if (entity.inUse) {
-                func(entity);
-            }
+        for (unsigned int slot : active) {
+            func(at(slot));
         }
     }
 
-    // Retrieve entities
-    std::vector<Entity>& getEntities() {
-        return entities;
-    }
+    size_t activeCount() const { return active.size(); }
+    size_t capacity() const { return nextAvailableID - firstID; }
+    size_t getHighWaterMark() const { return highWaterMark; }
+
+    // Telemetry for sizing the pool: chunks added after construction, acquires refused at the
+    // high-water mark, and the most entities ever in use at once
+    size_t getGrowthCount() const { return growthCount; }
+    size_t getExhaustionCount() const { return exhaustionCount; }
+    size_t getPeakActive() const { return peakActive; }
 
 private:
-    std::vector<Entity> entities;
+    static constexpr unsigned int npos = ~0u;  // End of the free list
+    static constexpr Entity::ID firstID = 2;
+
+    Entity& at(unsigned int slot) { return chunks[slot / chunkSize][slot % chunkSize]; }
+
+    // Add a chunk of free slots, or return false at the high-water mark
+    bool grow() {
+        size_t first = capacity();
+        size_t count = std::min(chunkSize, highWaterMark - first);
+        if (count == 0) return false;
+
+        chunks.emplace_back();
+        std::vector<Entity>& chunk = chunks.back();
+        chunk.reserve(chunkSize);  // Never reallocated after this, which keeps Entity* stable
+        for (size_t i = 0; i < count; ++i) {
+            chunk.emplace_back(Entity(nextAvailableID++));  // Create entities
+        }
+        links.resize(first + count);
+        active.reserve(first + count);
+
+        // Chain the new slots in order, so acquires hand out the lowest IDs first
+        for (size_t i = first + count; i-- > first;) {
+            links[i] = freeHead;
+            freeHead = static_cast<unsigned int>(i);
+        }
+
+        if (first > 0) ++growthCount;
+        return true;
+    }
+
+    size_t chunkSize;
+    size_t highWaterMark;
+    std::vector<std::vector<Entity>> chunks;  // Each holds chunkSize entities, the last may hold fewer
+    std::vector<unsigned int> links;  // Per slot: next free slot while free, position in active while in use
+    std::vector<unsigned int> active;  // Slots currently in use
     unsigned int nextAvailableID;
+    unsigned int freeHead;  // First free slot, or npos when every slot is in use
+    size_t growthCount;
+    size_t exhaustionCount;
+    size_t peakActive;
 };
@@ -0,0 +1,193 @@
+#include "Profiler.h"
+
+#ifdef CENTRAL_DEFENCE_PROFILER
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct ZoneRecord {
+	const char* name;
+	std::uint64_t begin;
+	std::uint64_t end;
+};
+
+// The most recent zones of one thread. Only the owner writes; readers go through written.
+// A thread that exits hands its ring, history and all, to the next thread that needs one.
+struct Ring {
+	static constexpr size_t Capacity = 16 * 1024;  // Power of two; a few seconds of zones per thread
+
+	std::array<ZoneRecord, Capacity> records;
+	std::atomic<std::uint64_t> written{ 0 };  // Zones ever recorded; the newest is at written - 1
+	std::uint64_t collected = 0;  // Reader side: zones already folded into the stats
+	std::atomic<bool> owned{ true };
+	unsigned int thread;  // Trace thread ID
+};
+
+// Last WindowSamples durations of one zone name
+struct NameStats {
+	const char* name;
+	std::array<float, Profiler::WindowSamples> samples;
+	size_t count;  // Samples ever added; the next goes to count % WindowSamples
+};
+
+struct State {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::mutex mutex;  // Guards rings and names; recording threads only take it to get a ring
+	std::vector<std::unique_ptr<Ring>> rings;
+	std::array<NameStats, Profiler::MaxZoneNames> names;
+	size_t nameCount = 0;
+};
+
+State& state() {
+	static State instance;
+	return instance;
+}
+
+// The calling thread's ring, released for reuse when the thread exits
+struct RingHandle {
+	Ring* ring = nullptr;
+
+	~RingHandle() {
+		if (ring) ring->owned.store(false, std::memory_order_release);
+	}
+};
+
+thread_local RingHandle threadRing;
+
+Ring& ownRing() {
+	if (!threadRing.ring) {
+		State& profiler = state();
+		std::lock_guard<std::mutex> lock(profiler.mutex);
+		for (const std::unique_ptr<Ring>& ring : profiler.rings) {
+			bool owned = false;
+			if (ring->owned.compare_exchange_strong(owned, true)) {
+				threadRing.ring = ring.get();
+				return *threadRing.ring;
+			}
+		}
+		profiler.rings.push_back(std::make_unique<Ring>());
+		threadRing.ring = profiler.rings.back().get();
+		threadRing.ring->thread = static_cast<unsigned int>(profiler.rings.size());
+	}
+	return *threadRing.ring;
+}
+
+NameStats* findName(State& profiler, const char* name) {
+	for (size_t i = 0; i < profiler.nameCount; ++i) {
+		if (profiler.names[i].name == name || std::strcmp(profiler.names[i].name, name) == 0) {
+			return &profiler.names[i];
+		}
+	}
+	if (profiler.nameCount == profiler.names.size()) return nullptr;  // Full; later names go untracked
+
+	NameStats& added = profiler.names[profiler.nameCount++];
+	added.name = name;
+	added.count = 0;
+	return &added;
+}
+
+}
+
+namespace Profiler {
+
+std::uint64_t now() {
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - state().start).count());
+}
+
+void registerThread() {
+	ownRing();
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end) {
+	Ring& ring = ownRing();
+	std::uint64_t index = ring.written.load(std::memory_order_relaxed);
+	ring.records[index & (Ring::Capacity - 1)] = ZoneRecord{ name, begin, end };
+	ring.written.store(index + 1, std::memory_order_release);
+}
+
+void collect() {
+	State& profiler = state();
+	std::lock_guard<std::mutex> lock(profiler.mutex);
+	for (const std::unique_ptr<Ring>& ring : profiler.rings) {
+		std::uint64_t written = ring->written.load(std::memory_order_acquire);
+		std::uint64_t first = std::max(ring->collected, written > Ring::Capacity ? written - Ring::Capacity : 0);
+
+		for (std::uint64_t i = first; i < written; ++i) {
+			const ZoneRecord& zone = ring->records[i & (Ring::Capacity - 1)];
+			if (NameStats* stats = findName(profiler, zone.name)) {
+				stats->samples[stats->count % WindowSamples] = (zone.end - zone.begin) / 1e6f;
+				++stats->count;
+			}
+		}
+		ring->collected = written;
+	}
+}
+
+size_t stats(ZoneStats* out, size_t max) {
+	State& profiler = state();
+	std::lock_guard<std::mutex> lock(profiler.mutex);
+
+	size_t count = std::min(max, profiler.nameCount);
+	for (size_t i = 0; i < count; ++i) {
+		const NameStats& name = profiler.names[i];
+		std::array<float, WindowSamples> sorted;
+		size_t samples = std::min(name.count, WindowSamples);
+		std::copy(name.samples.begin(), name.samples.begin() + samples, sorted.begin());
+
+		// Nearest-rank percentiles over the window
+		auto percentile = [&](float p) {
+			size_t rank = static_cast<size_t>(p * (samples - 1) + 0.5f);
+			std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + samples);
+			return sorted[rank];
+		};
+		out[i] = ZoneStats{ name.name, samples ? percentile(0.5f) : 0.f, samples ? percentile(0.99f) : 0.f, samples };
+	}
+	return count;
+}
+
+bool writeChromeTrace(const char* path) {
+	std::FILE* file = std::fopen(path, "w");
+	if (!file) return false;
+
+	State& profiler = state();
+	std::lock_guard<std::mutex> lock(profiler.mutex);
+
+	// Complete ("X") events in microseconds, one track per thread
+	std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool first = true;
+	for (const std::unique_ptr<Ring>& ring : profiler.rings) {
+		std::uint64_t written = ring->written.load(std::memory_order_acquire);
+		for (std::uint64_t i = written > Ring::Capacity ? written - Ring::Capacity : 0; i < written; ++i) {
+			const ZoneRecord& zone = ring->records[i & (Ring::Capacity - 1)];
+			std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				first ? "" : ",", zone.name, ring->thread, zone.begin / 1e3, (zone.end - zone.begin) / 1e3);
+			first = false;
+		}
+	}
+	std::fprintf(file, "\n]}\n");
+	return std::fclose(file) == 0;
+}
+
+}
+#else
+// Compiled out: nothing is recorded, so there is nothing to report
+namespace Profiler {
+
+std::uint64_t now() { return 0; }
+void record(const char*, std::uint64_t, std::uint64_t) {}
+void registerThread() {}
+void collect() {}
+size_t stats(ZoneStats*, size_t) { return 0; }
+bool writeChromeTrace(const char*) { return false; }
+
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Scoped timing zones, compiled in by defining CENTRAL_DEFENCE_PROFILER. Without it
+// PROFILE_ZONE expands to nothing and the functions below report no data, so shipped builds
+// pay nothing.
+//
+// A zone records its name, start and end into a fixed ring owned by the calling thread, so
+// timing a system on a worker takes no lock and never allocates once the thread's ring exists.
+// Once per frame, collect() folds the new zones into rolling per-name stats for the Debug
+// overlay; writeChromeTrace() dumps every zone still in the rings for chrome://tracing or
+// Perfetto. Names must outlive the program, such as string literals.
+//   void MovementSystem::update(...) { PROFILE_ZONE("movement"); ... }
+namespace Profiler {
+    // Nanoseconds since the profiler started
+    std::uint64_t now();
+
+    void record(const char* name, std::uint64_t begin, std::uint64_t end);
+
+    // Give the calling thread its ring now rather than in its first zone, which would allocate
+    // mid-frame. JobScheduler does this for its workers and for the thread that creates it.
+    void registerThread();
+
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name(name), begin(now()) {}
+        ~Zone() { record(name, begin, now()); }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t begin;
+    };
+
+    struct ZoneStats {
+        const char* name;
+        float p50Ms;
+        float p99Ms;
+        size_t samples;  // How many of the last WindowSamples the percentiles cover
+    };
+
+    constexpr size_t WindowSamples = 240;  // Rolling window per zone name: four seconds of ticks at 60 Hz
+    constexpr size_t MaxZoneNames = 64;
+
+    // Fold zones finished since the last call into the rolling stats. Call once per frame from
+    // one thread, while no other thread is inside a zone, e.g. after the simulation tick.
+    void collect();
+
+    // Stats for up to max zone names, in the order they were first seen; returns how many
+    size_t stats(ZoneStats* out, size_t max);
+
+    // Write the zones held in every thread's ring as Chrome trace_event JSON. False if the
+    // file can't be written or the profiler is compiled out.
+    bool writeChromeTrace(const char* path);
+
+    constexpr bool enabled() {
+#ifdef CENTRAL_DEFENCE_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef CENTRAL_DEFENCE_PROFILER
+#define PROFILE_ZONE(name) ::Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
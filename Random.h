@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// xoshiro128** run as four independent lanes, with state stored lane by lane so one step of all
+// four is a few shifts, xors and adds the compiler turns into SSE2. Under 100 bytes against
+// 2.5 KB for std::mt19937, so many simulations side by side stay in cache.
+//
+// Every draw comes from one stream: the scalar calls hand out the four values of a step one
+// at a time, and fill() carries on from wherever they left off. The same seed therefore gives
+// the same numbers however they are asked for. Meets UniformRandomBitGenerator, but below()
+// and unit() are cheaper than constructing a std distribution per draw.
+class Random {
+public:
+    using result_type = std::uint32_t;
+    static constexpr size_t Lanes = 4;
+
+    explicit Random(std::uint64_t seed = 1) { reseed(seed); }
+
+    // Expand seed into every lane with splitmix64, which never gives a lane all zero bits
+    void reseed(std::uint64_t seed) {
+        std::uint32_t* words[] = { s0, s1, s2, s3 };
+        for (size_t word = 0; word < 4; ++word) {
+            for (size_t lane = 0; lane < Lanes; lane += 2) {
+                seed += 0x9E3779B97F4A7C15ull;
+                std::uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                z ^= z >> 31;
+                words[word][lane] = static_cast<std::uint32_t>(z);
+                words[word][lane + 1] = static_cast<std::uint32_t>(z >> 32);
+            }
+        }
+        next = Lanes;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (next == Lanes) {
+            step(buffer);
+            next = 0;
+        }
+        return buffer[next++];
+    }
+
+    // Uniform in [0, bound) by multiply and shift. The bias is under bound / 2^32, far too
+    // small to matter for picking spawns.
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>((*this)()) * bound) >> 32);
+    }
+
+    // Uniform in [0, 1), from the top 24 bits so every value is exact in a float
+    float unit() { return toUnit((*this)()); }
+    static float toUnit(result_type bits) { return (bits >> 8) * (1.f / 16777216.f); }
+
+    // count draws into out, a whole step of the four lanes at a time
+    void fill(result_type* out, size_t count) {
+        while (count && next < Lanes) {  // Hand out what a scalar call left over first
+            *out++ = buffer[next++];
+            --count;
+        }
+        for (; count >= Lanes; count -= Lanes, out += Lanes) {
+            step(out);
+        }
+        while (count--) {
+            *out++ = (*this)();
+        }
+    }
+
+private:
+    static std::uint32_t rotl(std::uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+    void step(result_type* out) {
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            out[lane] = rotl(s1[lane] * 5, 7) * 9;
+            std::uint32_t t = s1[lane] << 9;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = rotl(s3[lane], 11);
+        }
+    }
+
+    alignas(16) std::uint32_t s0[Lanes];
+    alignas(16) std::uint32_t s1[Lanes];
+    alignas(16) std::uint32_t s2[Lanes];
+    alignas(16) std::uint32_t s3[Lanes];
+    alignas(16) result_type buffer[Lanes];  // The latest step's values, for the scalar calls
+    size_t next;  // Next unused value in buffer; Lanes when it is spent
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "Components.h"
+
+// Shared shapes for the kinds whose entities all look alike. Every entity of such a kind points
+// its Renderable at the kind's prototype, so spawning one allocates nothing and despawning it has
+// nothing to free. Prototypes live for the whole program and are never modified; RenderSystem
+// draws their entities as one batch, placing copies of the outline instead of moving the shape.
+namespace Shapes {
+    inline sf::CircleShape makeCircle(float radius, const sf::Color& colour) {
+        sf::CircleShape shape(radius);
+        shape.setFillColor(colour);
+        return shape;
+    }
+
+    // The shape every entity of kind draws with, or nullptr for kinds with shapes of their own
+    inline sf::CircleShape* prototype(EntityKind kind) {
+        static sf::CircleShape projectile = makeCircle(5.f, sf::Color::Red);
+        static sf::CircleShape speedPowerUp = makeCircle(5.f, sf::Color::Green);  // Different colour for power-up
+        static sf::CircleShape sizePowerUp = makeCircle(5.f, sf::Color::Magenta);
+
+        switch (kind) {
+        case EntityKind::Projectile: return &projectile;
+        case EntityKind::SpeedPowerUp: return &speedPowerUp;
+        case EntityKind::SizePowerUp: return &sizePowerUp;
+        default: return nullptr;
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include "Simulation.h"
+#include "Shapes.h"
+
+Simulation::Simulation(const Arena& arena, unsigned int workerThreads, std::uint32_t seed)
+	: arena(arena),
+	seed(seed),
+	random(seed),
+	projectilePool(100, 10000), // Initialise projectilePool, growing 100 at a time up to 10000
+	healthSystem(projectilePool, gameManager),  // Initialise healthSystem
+	damageSystem(healthSystem),  // Initialise collision resolvers
+	powerUpSystem(collisionSystem),
+	despawnSystem(projectilePool),
+	projectileSpawnSystem(projectilePool, random, 4.f), // Initialise projectileSpanSystem
+	gameManager(projectileSpawnSystem, collisionSystem),  // Initialise gameManager
+	tickDeltaTime(0.f),
+	scheduler(workerThreads)
+{
+	initialisePlayer();
+	initialiseBase();
+	buildSystemGraph();
+	buildQueries();
+	movementSystem.setScheduler(&scheduler);
+	collisionSystem.setScheduler(&scheduler);
+
+	// Update player minimum rotation radius
+	Rotation* playerRotation = componentManager.getComponent<Rotation>(playerEntity);
+	playerRotation->minRadius =
+		static_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(baseEntity)->shape)->getRadius()
+		+ static_cast<sf::CircleShape*>(componentManager.getComponent<Renderable>(playerEntity)->shape)->getRadius();
+}
+
+void Simulation::update(float deltaTime) {
+	tickDeltaTime = deltaTime;
+
+	componentManager.setSystemsRunning(true);
+	systems.run(scheduler);
+	componentManager.setSystemsRunning(false);
+}
+
+std::uint64_t Simulation::stateHash() {
+	// FNV-1a over each entity's bits, summed so the order entities are visited in doesn't matter
+	auto hashEntity = [](Entity::ID entity, const void* data, size_t size) {
+		std::uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](const unsigned char* bytes, size_t count) {
+			for (size_t i = 0; i < count; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+		mix(reinterpret_cast<const unsigned char*>(&entity), sizeof(entity));
+		mix(static_cast<const unsigned char*>(data), size);
+		return hash;
+	};
+
+	std::uint64_t hash = 0;
+	componentManager.forEach<Transform>([&](Entity::ID entity, Transform& transform) {
+		float position[] = { transform.x, transform.y, transform.angle };
+		hash += hashEntity(entity, position, sizeof(position));
+	});
+	componentManager.forEach<Health>([&](Entity::ID entity, Health& health) {
+		int values[] = { health.currentHealth, health.maxHealth };
+		hash += hashEntity(entity, values, sizeof(values));
+	});
+	return hash;
+}
+
+// Systems in the order a single thread would run them. Each declares what it reads and writes,
+// components and shared state both, and the graph only runs side by side the ones that can't see
+// each other's changes.
+void Simulation::buildSystemGraph() {
+	systems.add("snapshot", SystemAccess().read<Transform>().write<PreviousTransform>(),
+		[this] { snapshotSystem.update(componentManager); });
+	systems.add("movement", SystemAccess().read<Velocity>().write<Transform, BoxCollider>().with<Velocity>(),
+		[this] { movementSystem.update(componentManager, tickDeltaTime); });
+	systems.add("rotation", SystemAccess().read<Velocity>().write<Rotation, Transform>().without<Velocity>(),
+		[this] { rotationSystem.update(componentManager, tickDeltaTime); });
+	systems.add("collision", SystemAccess().read<Transform, Tag, Velocity>().write<BoxCollider, CircleCollider>()
+		.writeShared<CollisionEventQueue, CollisionSystem>(),
+		[this] { collisionSystem.update(componentManager); });
+	systems.add("damage", SystemAccess().write<Health>().readShared<CollisionEventQueue>(),
+		[this] { damageSystem.update(componentManager, collisionSystem.getEvents()); });
+	systems.add("power-up", SystemAccess().write<Rotation, Renderable, BoxCollider, CircleCollider>().readShared<CollisionEventQueue>(),
+		[this] { powerUpSystem.update(componentManager, arena, collisionSystem.getEvents()); });
+	systems.add("despawn", SystemAccess().changesStructure().writeShared<CollisionEventQueue, ObjectPool>(),  // Pops the events
+		[this] { despawnSystem.update(componentManager, collisionSystem.getEvents()); });
+	systems.add("spawn", SystemAccess().changesStructure().writeShared<ObjectPool, Random, ProjectileSpawnSystem>(),
+		[this] { projectileSpawnSystem.update(componentManager, arena, tickDeltaTime); });
+	systems.add("health", SystemAccess().changesStructure().writeShared<ObjectPool, ProjectileSpawnSystem>(),  // Game over resets every entity and the spawner
+		[this] { healthSystem.update(componentManager, arena); });
+}
+
+// Views and groups are built the first time they're asked for, which isn't safe with systems
+// running side by side, so build every one the systems use before the first tick. A system that
+// starts using a new one must add it here; the component manager asserts otherwise.
+void Simulation::buildQueries() {
+	componentManager.view<PreviousTransform, Transform>();  // Snapshot
+#ifdef CENTRAL_DEFENCE_ARCHETYPE_STORAGE
+	componentManager.view<Velocity, Transform>();  // Movement
+#else
+	componentManager.group<Velocity, Transform, BoxCollider>();  // Movement
+#endif
+	componentManager.view<Rotation, Transform>();  // Rotation
+	componentManager.view<BoxCollider, Transform>();  // Collision
+	componentManager.view<CircleCollider, Transform>();
+	componentManager.view<Health>();  // Health
+	componentManager.view<Velocity>();  // Game over, in ProjectileSpawnSystem::reset
+}
+
+void Simulation::initialisePlayer() {
+	Entity player = Entity(0);
+	componentManager.addComponent<Transform>(player.getId(), Transform(0.f, 0.f, 0.f));
+	componentManager.addComponent<PreviousTransform>(player.getId(), PreviousTransform(0.f, 0.f, 0.f));
+	playerShape = Shapes::makeCircle(10.f, sf::Color::Cyan);
+	componentManager.addComponent<Renderable>(player.getId(), Renderable(&playerShape, nullptr));
+	float x = arena.width / 2 - playerShape.getRadius();
+	float y = arena.height / 2 - playerShape.getRadius();
+	float maxRadius = arena.width / 2 - playerShape.getRadius();
+	componentManager.addComponent<Rotation>(player.getId(), Rotation(0.f, 80.f, true, x, y, arena.width / 4, maxRadius, 1.f));
+	componentManager.addComponent<BoxCollider>(player.getId(), BoxCollider(x, y, playerShape.getRadius() * 2, playerShape.getRadius() * 2));
+	componentManager.addComponent<Tag>(player.getId(), Tag(EntityKind::Player));
+	playerEntity = player.getId();
+}
+
+void Simulation::initialiseBase() {
+	Entity base = Entity(1);
+	baseShape = Shapes::makeCircle(100.f, sf::Color::White);
+	componentManager.addComponent<Renderable>(base.getId(), Renderable(&baseShape, nullptr));
+	float centerX = arena.width / 2 - baseShape.getRadius();
+	float centerY = arena.height / 2 - baseShape.getRadius();
+	componentManager.addComponent<Transform>(base.getId(), Transform(centerX, centerY, 0.f));
+	componentManager.addComponent<CircleCollider>(base.getId(), CircleCollider(centerX + baseShape.getRadius(), centerY + baseShape.getRadius(), baseShape.getRadius()));
+	componentManager.addComponent<Health>(base.getId(), Health(4));  // Add Health component with 4 max health
+	componentManager.addComponent<Tag>(base.getId(), Tag(EntityKind::Base));
+	baseEntity = base.getId();
+}
+
+void Simulation::initialiseProjectile(float startX, float startY, float velocityX, float velocityY) {
+	// Get a projectile from the pool
+	Entity* projectile = projectilePool.acquire();
+	if (!projectile) return;  // If no available projectile, do nothing
+
+	// Initialize projectile components
+	componentManager.addComponent<Transform>(projectile->getId(), Transform(startX, startY, 0.f));
+	componentManager.addComponent<PreviousTransform>(projectile->getId(), PreviousTransform(startX, startY, 0.f));
+	componentManager.addComponent<Velocity>(projectile->getId(), Velocity(velocityX, velocityY));
+
+	sf::CircleShape* shape = Shapes::prototype(EntityKind::Projectile);
+	componentManager.addComponent<Renderable>(projectile->getId(), Renderable(shape));
+	componentManager.addComponent<Tag>(projectile->getId(), Tag(EntityKind::Projectile));
+
+	componentManager.addComponent<BoxCollider>(projectile->getId(), BoxCollider(startX, startY, shape->getRadius() * 2, shape->getRadius() * 2));
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Systems.h"
+#include "ObjectPool.h"
+#include "JobScheduler.h"
+#include "SystemGraph.h"
+#include "Random.h"
+#include <cstdint>
+
+// The entities and systems behind Game::update, with no window attached.
+// Game draws it every frame; the headless driver steps it on its own.
+// Each tick runs the systems through a SystemGraph, so systems that touch different
+// components run at the same time on workerThreads threads besides the caller's.
+//
+// All randomness comes from one generator seeded with seed, so the same seed, arena, tick length
+// and per-tick input always play out the same, whatever the worker count.
+class Simulation {
+public:
+    explicit Simulation(const Arena& arena, unsigned int workerThreads = JobScheduler::defaultWorkerCount(),
+        std::uint32_t seed = DefaultSeed);
+
+    void update(float deltaTime);
+
+    ComponentManager& getComponentManager() { return componentManager; }
+    CollisionSystem& getCollisionSystem() { return collisionSystem; }
+    const ObjectPool& getProjectilePool() const { return projectilePool; }
+    const Arena& getArena() const { return arena; }
+    unsigned int getWorkerThreads() const { return scheduler.workerCount(); }
+    std::uint32_t getSeed() const { return seed; }
+
+    // Hash of every entity's position and health, for checking that two runs match
+    std::uint64_t stateHash();
+
+    static constexpr std::uint32_t DefaultSeed = 1;
+
+    Entity::ID getPlayerEntity() const { return playerEntity; }
+    Entity::ID getBaseEntity() const { return baseEntity; }
+
+private:
+    void initialisePlayer();
+    void initialiseBase();
+    void initialiseProjectile(float startX, float startY, float velocityX, float velocityY);
+    void buildSystemGraph();
+    void buildQueries();
+
+    Arena arena;
+    std::uint32_t seed;
+    Random random;  // Declared before the systems that keep a reference to it
+    sf::CircleShape playerShape;  // Player and base shapes change in play, so each owns its own
+    sf::CircleShape baseShape;
+    ComponentManager componentManager;
+    ObjectPool projectilePool;
+    SnapshotSystem snapshotSystem;
+    MovementSystem movementSystem;
+    RotationSystem rotationSystem;
+    CollisionSystem collisionSystem;
+    HealthSystem healthSystem;
+    DamageSystem damageSystem;
+    PowerUpSystem powerUpSystem;
+    DespawnSystem despawnSystem;
+    ProjectileSpawnSystem projectileSpawnSystem;
+    GameManager gameManager;
+
+    Entity::ID playerEntity;
+    Entity::ID baseEntity;
+
+    SystemGraph systems;
+    float tickDeltaTime;  // deltaTime of the tick in progress, read by the graph's systems
+    JobScheduler scheduler;  // Declared last, so its threads stop before anything they use is destroyed
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+
+// Sine and cosine of angles in degrees from a table of one turn, linearly interpolated.
+// Accurate to about 3e-7, close to float precision, and much cheaper than std::sin and
+// std::cos in double. Meant for jumps to an arbitrary angle; RotationSystem turns orbits
+// incrementally and only comes here to re-derive a direction.
+namespace SinCosTable {
+    constexpr size_t Size = 4096;  // Entries per turn; a power of two so wrapping is a mask
+
+    struct Table {
+        float sine[Size + 1];  // One extra entry so interpolation never wraps mid-pair
+        float cosine[Size + 1];
+
+        Table() {
+            const double pi = 3.14159265358979323846;
+            for (size_t i = 0; i <= Size; ++i) {
+                double radians = 2.0 * pi * static_cast<double>(i) / Size;
+                sine[i] = static_cast<float>(std::sin(radians));
+                cosine[i] = static_cast<float>(std::cos(radians));
+            }
+        }
+    };
+
+    inline const Table& table() {
+        static const Table instance;
+        return instance;
+    }
+
+    // Any angle, negative or past a full turn, wraps onto the table
+    inline void lookup(float degrees, float& sine, float& cosine) {
+        const Table& entries = table();
+        float position = degrees * (Size / 360.f);
+        float whole = std::floor(position);
+        float fraction = position - whole;
+        size_t index = static_cast<size_t>(static_cast<long long>(whole)) & (Size - 1);
+
+        sine = entries.sine[index] + (entries.sine[index + 1] - entries.sine[index]) * fraction;
+        cosine = entries.cosine[index] + (entries.cosine[index + 1] - entries.cosine[index]) * fraction;
+    }
+}
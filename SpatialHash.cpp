@@ -0,0 +1,88 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialHash::clear() {
+	cellEntries.clear();
+	bucketItems.clear();
+}
+
+void SpatialHash::insert(unsigned int index, const sf::FloatRect& bounds) {
+	int minX = cellCoord(bounds.left);
+	int minY = cellCoord(bounds.top);
+	int maxX = cellCoord(bounds.left + bounds.width);
+	int maxY = cellCoord(bounds.top + bounds.height);
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			cellEntries.push_back({ hashCell(x, y), index });
+		}
+	}
+
+	if (index >= lastSeen.size()) {
+		lastSeen.resize(index + 1, 0);
+	}
+}
+
+void SpatialHash::build() {
+	// Roughly two buckets per entry keeps chains short without a large table
+	size_t bucketCount = 64;
+	while (bucketCount < cellEntries.size() * 2) {
+		bucketCount <<= 1;
+	}
+	bucketMask = static_cast<unsigned int>(bucketCount - 1);
+
+	// Counting sort of the entries by bucket
+	bucketStart.assign(bucketCount + 1, 0);
+	for (const CellEntry& entry : cellEntries) {
+		++bucketStart[(entry.cellHash & bucketMask) + 1];
+	}
+	for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+		bucketStart[bucket + 1] += bucketStart[bucket];
+	}
+
+	bucketItems.resize(cellEntries.size());
+	bucketCursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+	for (const CellEntry& entry : cellEntries) {
+		bucketItems[bucketCursor[entry.cellHash & bucketMask]++] = entry.index;
+	}
+}
+
+void SpatialHash::query(const sf::FloatRect& bounds, std::vector<unsigned int>& result) {
+	result.clear();
+	if (bucketItems.empty()) return;
+
+	if (++queryStamp == 0) {  // Stamp wrapped, so forget every previous query
+		std::fill(lastSeen.begin(), lastSeen.end(), 0);
+		queryStamp = 1;
+	}
+
+	int minX = cellCoord(bounds.left);
+	int minY = cellCoord(bounds.top);
+	int maxX = cellCoord(bounds.left + bounds.width);
+	int maxY = cellCoord(bounds.top + bounds.height);
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			unsigned int bucket = hashCell(x, y) & bucketMask;
+			for (unsigned int i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+				unsigned int index = bucketItems[i];
+				if (lastSeen[index] != queryStamp) {
+					lastSeen[index] = queryStamp;
+					result.push_back(index);
+				}
+			}
+		}
+	}
+
+	// Callers rely on insertion order to match the brute-force pair order
+	std::sort(result.begin(), result.end());
+}
+
+int SpatialHash::cellCoord(float value) const {
+	return static_cast<int>(std::floor(value / cellSize));
+}
+
+unsigned int SpatialHash::hashCell(int x, int y) {
+	return static_cast<unsigned int>(x) * 73856093u ^ static_cast<unsigned int>(y) * 19349663u;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+// Uniform-grid broadphase. Items are inserted by index with their bounding box, hashed into
+// every cell they overlap, then packed into flat per-bucket arrays by build().
+// Buffers are reused between frames, so a rebuild doesn't allocate once they have grown.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 10.f) : cellSize(cellSize), bucketMask(0), queryStamp(0) {}
+
+    void setCellSize(float size) { cellSize = size; }
+    float getCellSize() const { return cellSize; }
+
+    // Start a new frame
+    void clear();
+
+    // Register an item; call build() once every item has been inserted
+    void insert(unsigned int index, const sf::FloatRect& bounds);
+
+    void build();
+
+    // Collect the indices of every item sharing a cell with the bounds, in ascending order.
+    // Hash collisions can produce extra candidates, so callers still run a narrowphase test.
+    void query(const sf::FloatRect& bounds, std::vector<unsigned int>& result);
+
+private:
+    struct CellEntry {
+        unsigned int cellHash;
+        unsigned int index;
+    };
+
+    float cellSize;
+    unsigned int bucketMask;
+    std::vector<CellEntry> cellEntries;  // One per (item, overlapped cell)
+    std::vector<unsigned int> bucketStart;  // Offsets into bucketItems, one past the end for the last bucket
+    std::vector<unsigned int> bucketItems;  // Item indices grouped by bucket
+    std::vector<unsigned int> bucketCursor;  // Fill position per bucket while building
+    std::vector<unsigned int> lastSeen;  // Per item, the query that last returned it (deduplicates multi-cell items)
+    unsigned int queryStamp;
+
+    int cellCoord(float value) const;
+    static unsigned int hashCell(int x, int y);
+};
@@ -0,0 +1,76 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+void SweepAndPrune::clear() {
+	incoming.clear();
+}
+
+void SweepAndPrune::insert(unsigned int index, Entity::ID entity, const sf::FloatRect& bounds) {
+	incoming.push_back({ entity, index, bounds.left, bounds.left + bounds.width, bounds.top, bounds.top + bounds.height });
+}
+
+void SweepAndPrune::build() {
+	for (size_t i = 0; i < incoming.size(); ++i) {
+		Entity::ID index = Entity::indexOf(incoming[i].entity);
+		if (index >= slotOf.size()) {
+			slotOf.resize(index + 1, npos);
+		}
+		slotOf[index] = static_cast<unsigned int>(i);
+	}
+
+	// Keep last frame's order for entities that are still present, refreshed with their new bounds.
+	// A recycled slot holds a different generation, so it counts as a new arrival.
+	scratch.clear();
+	for (const Interval& previous : sorted) {
+		Entity::ID index = Entity::indexOf(previous.entity);
+		if (index < slotOf.size() && slotOf[index] != npos && incoming[slotOf[index]].entity == previous.entity) {
+			scratch.push_back(incoming[slotOf[index]]);
+			slotOf[index] = npos;
+		}
+	}
+
+	// New arrivals go on the end and are sorted into place below
+	for (const Interval& interval : incoming) {
+		Entity::ID index = Entity::indexOf(interval.entity);
+		if (slotOf[index] != npos) {
+			scratch.push_back(interval);
+			slotOf[index] = npos;
+		}
+	}
+	sorted.swap(scratch);
+
+	// Insertion sort, cheap when the order barely changed since the last frame
+	maxWidth = 0.f;
+	for (size_t i = 0; i < sorted.size(); ++i) {
+		Interval interval = sorted[i];
+		size_t j = i;
+		while (j > 0 && sorted[j - 1].minX > interval.minX) {
+			sorted[j] = sorted[j - 1];
+			--j;
+		}
+		sorted[j] = interval;
+		maxWidth = std::max(maxWidth, interval.maxX - interval.minX);
+	}
+}
+
+void SweepAndPrune::query(const sf::FloatRect& bounds, std::vector<unsigned int>& result) const {
+	result.clear();
+
+	float left = bounds.left;
+	float right = bounds.left + bounds.width;
+	float top = bounds.top;
+	float bottom = bounds.top + bounds.height;
+
+	// Nothing starting further left than the widest interval can still reach the query
+	auto first = std::lower_bound(sorted.begin(), sorted.end(), left - maxWidth,
+		[](const Interval& interval, float x) { return interval.minX < x; });
+
+	for (auto it = first; it != sorted.end() && it->minX <= right; ++it) {
+		if (it->maxX >= left && it->minY <= bottom && it->maxY >= top) {
+			result.push_back(it->index);
+		}
+	}
+
+	// Callers rely on insertion order to match the brute-force pair order
+	std::sort(result.begin(), result.end());
+}
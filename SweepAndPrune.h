@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Entity.h"
+
+// Sort-and-sweep broadphase on the x axis. The intervals stay sorted between frames and are
+// re-sorted with insertion sort, which is close to linear while projectiles move smoothly.
+// Items are matched across frames by entity ID, since their per-frame indices change.
+class SweepAndPrune {
+public:
+    SweepAndPrune() : maxWidth(0.f) {}
+
+    // Start a new frame
+    void clear();
+
+    // Register an item; call build() once every item has been inserted
+    void insert(unsigned int index, Entity::ID entity, const sf::FloatRect& bounds);
+
+    void build();
+
+    // Collect the indices of every item whose bounds overlap, in ascending order
+    void query(const sf::FloatRect& bounds, std::vector<unsigned int>& result) const;
+
+private:
+    struct Interval {
+        Entity::ID entity;
+        unsigned int index;
+        float minX, maxX;
+        float minY, maxY;
+    };
+
+    static constexpr unsigned int npos = ~0u;
+
+    std::vector<Interval> sorted;  // Ordered by minX, kept from the previous frame
+    std::vector<Interval> incoming;  // This frame's items, in insertion order
+    std::vector<Interval> scratch;
+    std::vector<unsigned int> slotOf;  // Entity index -> position in incoming
+    float maxWidth;  // Widest interval, bounds how far back a query has to look
+};
@@ -0,0 +1,60 @@
+#include "SystemGraph.h"
+#include "Profiler.h"
+
+void SystemGraph::add(const char* name, const SystemAccess& access, std::function<void()> run) {
+	size_t index = nodes.size();
+	nodes.push_back(Node{ name, access, std::move(run), {}, 0 });
+
+	for (size_t earlier = 0; earlier < index; ++earlier) {
+		if (nodes[earlier].access.conflictsWith(access)) {
+			nodes[earlier].dependents.push_back(index);
+			++nodes[index].dependencies;
+		}
+	}
+
+	remaining = std::make_unique<std::atomic<size_t>[]>(nodes.size());
+}
+
+void SystemGraph::run(JobScheduler& scheduler) {
+	if (scheduler.workerCount() == 0) {
+		runSerial();  // Nothing to overlap with, so skip the bookkeeping
+		return;
+	}
+
+	this->scheduler = &scheduler;
+	finished.store(0, std::memory_order_relaxed);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		remaining[i].store(nodes[i].dependencies, std::memory_order_relaxed);
+	}
+
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		if (nodes[i].dependencies == 0) {
+			scheduler.submit(Job{ &SystemGraph::runNode, this, i });
+		}
+	}
+	scheduler.wait([this] { return finished.load(std::memory_order_acquire) == nodes.size(); });
+}
+
+void SystemGraph::runSerial() {
+	for (Node& node : nodes) {
+		PROFILE_ZONE(node.name);
+		node.run();
+	}
+}
+
+void SystemGraph::runNode(void* context, size_t index) {
+	SystemGraph& graph = *static_cast<SystemGraph*>(context);
+	Node& node = graph.nodes[index];
+	{
+		PROFILE_ZONE(node.name);
+		node.run();
+	}
+
+	// The last dependency to finish releases each dependent
+	for (size_t dependent : node.dependents) {
+		if (graph.remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			graph.scheduler->submit(Job{ &SystemGraph::runNode, &graph, dependent });
+		}
+	}
+	graph.finished.fetch_add(1, std::memory_order_release);
+}
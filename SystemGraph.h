@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ComponentFamily.h"
+#include "JobScheduler.h"
+
+// What a system touches, declared up front so SystemGraph can tell which systems may run at
+// the same time. read() and write() take component types. with<T>() and without<T>() narrow the
+// entities a system touches: two systems that write the same component still run side by side
+// when one only visits entities with T and the other only entities without it.
+//
+// State outside the components is invisible to the graph unless declared with readShared() and
+// writeShared(), by its type: the collision event queue, ObjectPool, Random, a system's own
+// buffers when another system reaches into them. Disjoint entities don't make shared state
+// disjoint, so with() and without() never excuse a conflict over it. Declare it even on a
+// system that changesStructure(), so the order stays right if that system stops running alone.
+struct SystemAccess {
+    std::uint64_t reads = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t sharedReads = 0;
+    std::uint64_t sharedWrites = 0;
+    std::uint64_t withMask = 0;
+    std::uint64_t withoutMask = 0;
+    bool structural = false;
+
+    template <typename... Ts> SystemAccess& read() { reads |= (bit<Ts>() | ... | 0); return *this; }
+    template <typename... Ts> SystemAccess& write() { writes |= (bit<Ts>() | ... | 0); return *this; }
+    template <typename... Ts> SystemAccess& readShared() { sharedReads |= (bit<Ts>() | ... | 0); return *this; }
+    template <typename... Ts> SystemAccess& writeShared() { sharedWrites |= (bit<Ts>() | ... | 0); return *this; }
+    template <typename T> SystemAccess& with() { withMask |= bit<T>(); return *this; }
+    template <typename T> SystemAccess& without() { withoutMask |= bit<T>(); return *this; }
+
+    // Adds or destroys entities or components, which reshapes pools and views; runs alone
+    SystemAccess& changesStructure() { structural = true; return *this; }
+
+    bool conflictsWith(const SystemAccess& other) const {
+        if (structural || other.structural) return true;
+        if ((sharedWrites & (other.sharedReads | other.sharedWrites)) || (sharedReads & other.sharedWrites)) return true;
+        if ((withMask & other.withoutMask) || (withoutMask & other.withMask)) return false;  // Disjoint entities
+        return (writes & (other.reads | other.writes)) || (reads & other.writes);
+    }
+
+    template <typename T>
+    static std::uint64_t bit() {
+        AccessFamily::ID id = AccessFamily::id<T>();
+        assert(id < 64 && "SystemAccess masks hold 64 types");
+        return std::uint64_t(1) << id;
+    }
+};
+
+// The systems of one simulation tick. Each system waits for every earlier system it conflicts
+// with, so a tick produces the same state as running them one after another in the order added,
+// and systems that don't conflict run concurrently on a JobScheduler.
+class SystemGraph {
+public:
+    void add(const char* name, const SystemAccess& access, std::function<void()> run);
+
+    // Run every system once, concurrently where their access allows
+    void run(JobScheduler& scheduler);
+
+    // Run every system once on the calling thread, in the order added
+    void runSerial();
+
+    size_t size() const { return nodes.size(); }
+
+private:
+    struct Node {
+        const char* name;
+        SystemAccess access;
+        std::function<void()> run;
+        std::vector<size_t> dependents;  // Later systems that wait for this one
+        size_t dependencies;  // Earlier systems this one waits for
+    };
+
+    static void runNode(void* context, size_t index);
+
+    std::vector<Node> nodes;
+    std::unique_ptr<std::atomic<size_t>[]> remaining;  // Per node, dependencies not yet finished this run
+    std::atomic<size_t> finished{ 0 };
+    JobScheduler* scheduler = nullptr;  // The scheduler of the run in progress
+};
@@ -1,135 +1,390 @@
 #include "Systems.h"
 #include "Commands.h"
+#include "Log.h"
+#include "MovementKernels.h"
+#include "Shapes.h"
+#include <algorithm>
 #include <cmath> 
-#include <iostream>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 void MovementSystem::update(ComponentManager& manager, float deltaTime) {
-	auto entities = manager.getEntitiesWithComponents<Transform, Velocity>();
-	for (auto entity : entities) {
-		if (!manager.isEntityInUse(entity)) continue;
+	// Moving entities' BoxColliders follow their Transform here, so CollisionSystem leaves them alone
+#ifdef CENTRAL_DEFENCE_ARCHETYPE_STORAGE
+	// Chunks keep each entity's components at the same row, so whole columns go to the kernel
+	auto integrate = [&](Archetype& archetype, size_t chunk) {
+		BoxCollider* boxes = archetype.has(ComponentFamily::id<BoxCollider>()) ? archetype.columnArray<BoxCollider>(chunk) : nullptr;
+		MovementKernels::integrate(archetype.columnArray<Velocity>(chunk), archetype.columnArray<Transform>(chunk), boxes,
+			archetype.rowsInChunk(chunk), deltaTime);
+	};
+
+	if (scheduler) {
+		manager.parallelForEachChunk<Velocity, Transform>(*scheduler, integrate);
+	}
+	else {
+		manager.forEachChunk<Velocity, Transform>(integrate);
+	}
+#else
+	// The group keeps moving entities' components row-aligned at the front of their pools, as an
+	// archetype chunk would, so the same kernel takes them
+	Group<Velocity, Transform, BoxCollider>& moving = manager.group<Velocity, Transform, BoxCollider>();
+	auto integrate = [&](size_t begin, size_t end) {
+		MovementKernels::integrate(moving.data<Velocity>() + begin, moving.data<Transform>() + begin,
+			moving.data<BoxCollider>() + begin, end - begin, deltaTime);
+	};
+
+	if (scheduler) {
+		// Sixteen rows is a whole number of cache lines in each of the three arrays
+		scheduler->parallelFor(moving.size(), scheduler->grainFor(moving.size(), 16, ComponentManager::ParallelMinimum), integrate);
+	}
+	else {
+		integrate(0, moving.size());
+	}
 
-		Transform* transform = manager.getComponent<Transform>(entity);
-		Velocity* velocity = manager.getComponent<Velocity>(entity);
-		transform->x += velocity->dx * deltaTime;
-		transform->y += velocity->dy * deltaTime;
+	// Anything with a Velocity but no BoxCollider sits past the group in the Velocity pool
+	ComponentPool<Velocity>& velocities = manager.getPool<Velocity>();
+	for (size_t i = moving.size(); i < velocities.size(); ++i) {
+		if (Transform* transform = manager.getComponent<Transform>(velocities.entities()[i])) {
+			MovementKernels::integrateScalar(&velocities.components()[i], transform, nullptr, 0, 1, deltaTime);
+		}
 	}
+#endif
 }
 
 void RotationSystem::update(ComponentManager& manager, float deltaTime) {
-	auto entities = manager.getEntitiesWithComponents<Rotation, Transform>();
-
-	for (auto entity : entities) {
-		if (!manager.isEntityInUse(entity)) continue;
+	manager.forEach<Rotation, Transform>([&](Entity::ID entity, Rotation& rotation, Transform& transform) {
+		if (!manager.isEntityInUse(entity)) return;
+		if (manager.getComponent<Velocity>(entity)) return;  // Left to MovementSystem, which may be running alongside
 
-		Rotation* rotation = manager.getComponent<Rotation>(entity);
-		Transform* transform = manager.getComponent<Transform>(entity);
+		// Calculate the angle increment
+		float angleIncrement = rotation.speed * deltaTime;
 
-		if (rotation && transform) {
-			// Calculate the angle increment
-			float angleIncrement = rotation->speed * deltaTime;
+		if (!rotation.clockwise) {
+			angleIncrement = -angleIncrement;
+		}
 
-			if (!rotation->clockwise) {
-				angleIncrement = -angleIncrement;
-			}
+		// Update the angle
+		rotation.angle += angleIncrement;
 
-			// Update the angle
-			rotation->angle += angleIncrement;
+		// Keep the angle within the range [0, 360)
+		if (rotation.angle >= 360.f) rotation.angle -= 360.f;
+		if (rotation.angle < 0.f) rotation.angle += 360.f;
 
-			// Keep the angle within the range [0, 360)
-			if (rotation->angle >= 360.f) rotation->angle -= 360.f;
-			if (rotation->angle < 0.f) rotation->angle += 360.f;
+		// The increment only changes with speed, direction or tick length, so its sine and
+		// cosine are worked out once and reused
+		if (angleIncrement != rotation.stepAngle) {
+			float radians = angleIncrement * static_cast<float>(M_PI / 180.0);
+			rotation.stepAngle = angleIncrement;
+			rotation.stepCos = std::cos(radians);
+			rotation.stepSin = std::sin(radians);
+		}
 
-			// Calculate the new position based on the angle and radius
-			transform->x = rotation->centerX + rotation->radius * std::cos(rotation->angle * M_PI / 180.f);
-			transform->y = rotation->centerY + rotation->radius * std::sin(rotation->angle * M_PI / 180.f);
+		if ((ticks + Entity::indexOf(entity)) % ResyncInterval == 0) {
+			SinCosTable::lookup(rotation.angle, rotation.directionY, rotation.directionX);
 		}
-	}
+		else {
+			// Turn the direction by the increment: a complex multiply instead of two trig calls
+			float directionX = rotation.directionX * rotation.stepCos - rotation.directionY * rotation.stepSin;
+			float directionY = rotation.directionY * rotation.stepCos + rotation.directionX * rotation.stepSin;
+			rotation.directionX = directionX;
+			rotation.directionY = directionY;
+		}
+
+		// Calculate the new position based on the direction and radius
+		transform.x = rotation.centerX + rotation.radius * rotation.directionX;
+		transform.y = rotation.centerY + rotation.radius * rotation.directionY;
+	});
+	++ticks;
+}
+
+
+
+void SnapshotSystem::update(ComponentManager& manager) {
+	manager.forEach<PreviousTransform, Transform>([&](Entity::ID, PreviousTransform& previous, Transform& transform) {
+		previous = PreviousTransform(transform);
+	});
 }
 
+// Blend from where an entity was at the previous tick to where it is now, turning the short
+// way round for the angle
+static Transform interpolate(const PreviousTransform& previous, const Transform& current, float alpha) {
+	float turn = current.angle - previous.angle;
+	if (turn > 180.f) turn -= 360.f;
+	if (turn < -180.f) turn += 360.f;
 
+	return Transform(previous.x + (current.x - previous.x) * alpha,
+		previous.y + (current.y - previous.y) * alpha,
+		previous.angle + turn * alpha);
+}
+
+RenderSystem::RenderSystem() : circles(sf::Triangles) {
+	for (EntityKind kind : { EntityKind::Projectile, EntityKind::SpeedPowerUp, EntityKind::SizePowerUp }) {
+		CircleBatch batch;
+		batch.prototype = Shapes::prototype(kind);
+		for (size_t i = 0; i < batch.prototype->getPointCount(); ++i) {
+			batch.points.push_back(batch.prototype->getPoint(i));
+		}
+		batches.push_back(batch);
+	}
+}
 
-void RenderSystem::render(ComponentManager& manager, sf::RenderWindow& window) {
-	auto entities = manager.getEntitiesWithComponents<Renderable, Transform>();
+void RenderSystem::render(ComponentManager& manager, sf::RenderWindow& window, float alpha) {
+	circles.clear();
 
-	for (auto entity : entities) {
+	for (auto [entity, renderable, current] : manager.view<Renderable, Transform>()) {
 		if (!manager.isEntityInUse(entity)) continue;
 
-		Transform* transform = manager.getComponent<Transform>(entity);
-		Renderable* renderable = manager.getComponent<Renderable>(entity);
+		const PreviousTransform* previous = manager.getComponent<PreviousTransform>(entity);
+		Transform transform = previous ? interpolate(*previous, *current, alpha) : *current;
 
-		if (renderable->shape) {
-			renderable->shape->setPosition(transform->x, transform->y);
-			renderable->shape->setRotation(transform->angle);
+		// Batch entities that share a prototype instead of drawing them one by one
+		auto batch = std::find_if(batches.begin(), batches.end(),
+			[&](const CircleBatch& candidate) { return candidate.prototype == renderable->shape; });
+		if (batch != batches.end()) {
+			appendCircle(*batch, transform);
+		}
+		else if (renderable->shape) {
+			renderable->shape->setPosition(transform.x, transform.y);
+			renderable->shape->setRotation(transform.angle);
 			window.draw(*renderable->shape);
 		}
 		else if (renderable->sprite) {
-			renderable->sprite->setPosition(transform->x, transform->y);
-			renderable->sprite->setRotation(transform->angle);
+			renderable->sprite->setPosition(transform.x, transform.y);
+			renderable->sprite->setRotation(transform.angle);
 			window.draw(*renderable->sprite);
 		}
 	}
+
+	if (circles.getVertexCount() > 0) {
+		window.draw(circles);
+	}
 }
 
-void CollisionSystem::update(ComponentManager& manager, sf::RenderWindow& window) {
+void RenderSystem::appendCircle(const CircleBatch& batch, const Transform& transform) {
+	// Same placement sf::Shape gives a drawn shape: rotate about the origin, then move to the position
+	float radians = transform.angle * static_cast<float>(M_PI) / 180.f;
+	float cosine = std::cos(radians);
+	float sine = std::sin(radians);
+	auto place = [&](const sf::Vector2f& point) {
+		return sf::Vector2f(transform.x + point.x * cosine - point.y * sine, transform.y + point.x * sine + point.y * cosine);
+	};
+
+	sf::Color colour = batch.prototype->getFillColor();
+	float radius = batch.prototype->getRadius();
+	sf::Vector2f center = place(sf::Vector2f(radius, radius));
+
+	// A fan of triangles from the centre, written as a plain triangle list so circles can share the array
+	size_t count = batch.points.size();
+	for (size_t i = 0; i < count; ++i) {
+		circles.append(sf::Vertex(center, colour));
+		circles.append(sf::Vertex(place(batch.points[i]), colour));
+		circles.append(sf::Vertex(place(batch.points[(i + 1) % count]), colour));
+	}
+}
+
+void CollisionSystem::update(ComponentManager& manager) {
 	// Get entities with either BoxCollider or CircleCollider and Transform components
-	auto entitiesWithBoxColliders = manager.getEntitiesWithComponents<BoxCollider, Transform>();
-	auto entitiesWithCircleColliders = manager.getEntitiesWithComponents<CircleCollider, Transform>();
+	auto& entitiesWithBoxColliders = manager.view<BoxCollider, Transform>();
+	auto& entitiesWithCircleColliders = manager.view<CircleCollider, Transform>();
 
 	// Update positions for entities with BoxColliders
-	for (auto entity : entitiesWithBoxColliders) {
-		if (!manager.isEntityInUse(entity)) continue;  // Skip inactive entities
+	auto syncBox = [&](Entity::ID entity, BoxCollider& boxCollider, Transform& transform) {
+		if (!manager.isEntityInUse(entity)) return;  // Skip inactive entities
+		if (manager.getComponent<Velocity>(entity)) return;  // Already synced by MovementSystem; nothing writes Velocity alongside
 
-		Transform* transform = manager.getComponent<Transform>(entity);
-		BoxCollider* boxCollider = manager.getComponent<BoxCollider>(entity);
-		if (transform && boxCollider) {
-			boxCollider->bounds.left = transform->x;
-			boxCollider->bounds.top = transform->y;
-		}
+		boxCollider.bounds.left = transform.x;
+		boxCollider.bounds.top = transform.y;
+	};
+
+	if (scheduler) {
+		manager.parallelForEach<BoxCollider, Transform>(*scheduler, syncBox);
+	}
+	else {
+		manager.forEach<BoxCollider, Transform>(syncBox);
 	}
 
 	// Update positions for entities with CircleColliders
-	for (auto entity : entitiesWithCircleColliders) {
+	manager.forEach<CircleCollider, Transform>([&](Entity::ID entity, CircleCollider& circleCollider, Transform& transform) {
+		if (!manager.isEntityInUse(entity)) return;  // Skip inactive entities
+
+		circleCollider.center.x = transform.x + circleCollider.radius;
+		circleCollider.center.y = transform.y + circleCollider.radius;
+	});
+
+	// Rebuild the broadphase now that collider positions are current
+	pairsTested = 0;
+	gatherColliders(manager, entitiesWithBoxColliders, boxColliders);
+	gatherColliders(manager, entitiesWithCircleColliders, circleColliders);
+
+	// Every event uses up at least one moving entity, so this many events always fit, and no
+	// query returns more candidates than there are colliders
+	events.reserve(events.size() + boxColliders.entities.size() + circleColliders.entities.size());
+	candidates.reserve(boxColliders.entities.size() + circleColliders.entities.size());
+	std::fill(claimed.begin(), claimed.end(), false);
+
+	// Check for collisions between entities
+	checkAllCollisions(boxColliders, boxColliders);
+	checkAllCollisions(boxColliders, circleColliders);
+	checkAllCollisions(circleColliders, circleColliders);
+}
+
+template <typename ColliderView, typename ColliderType>
+void CollisionSystem::gatherColliders(ComponentManager& manager, const ColliderView& view, ColliderSet<ColliderType>& colliderSet) {
+	colliderSet.entities.clear();
+	colliderSet.colliders.clear();
+	colliderSet.kinds.clear();
+
+	for (auto [entity, collider, transform] : view) {
 		if (!manager.isEntityInUse(entity)) continue;  // Skip inactive entities
 
-		Transform* transform = manager.getComponent<Transform>(entity);
-		CircleCollider* circleCollider = manager.getComponent<CircleCollider>(entity);
-		if (transform && circleCollider) {
-			circleCollider->center.x = transform->x + circleCollider->radius;
-			circleCollider->center.y = transform->y + circleCollider->radius;
+		Tag* tag = manager.getComponent<Tag>(entity);
+		colliderSet.entities.push_back(entity);
+		colliderSet.colliders.push_back(collider);
+		colliderSet.kinds.push_back(tag ? tag->kind : EntityKind::None);
+
+		if (Entity::indexOf(entity) >= claimed.size()) {
+			claimed.resize(Entity::indexOf(entity) + 1, false);
 		}
 	}
 
-	// Check for collisions between entities
-	checkAllCollisions<BoxCollider, BoxCollider>(manager, window, entitiesWithBoxColliders, entitiesWithBoxColliders);
-	checkAllCollisions<BoxCollider, CircleCollider>(manager, window, entitiesWithBoxColliders, entitiesWithCircleColliders);
-	checkAllCollisions<CircleCollider, CircleCollider>(manager, window, entitiesWithCircleColliders, entitiesWithCircleColliders);
+	rebuildBroadphase(colliderSet);
+}
+
+template <typename ColliderType>
+void CollisionSystem::rebuildBroadphase(ColliderSet<ColliderType>& colliderSet) {
+	if constexpr (std::is_same<ColliderType, BoxCollider>::value) {
+		colliderSet.bounds.clear();
+		for (BoxCollider* box : colliderSet.colliders) {
+			colliderSet.bounds.push_back(box->bounds);
+		}
+	}
+
+	switch (broadphase) {
+	case Broadphase::BruteForce:
+		break;
+	case Broadphase::UniformGrid:
+		colliderSet.grid.clear();
+		for (size_t i = 0; i < colliderSet.colliders.size(); ++i) {
+			colliderSet.grid.insert(static_cast<unsigned int>(i), getBounds(colliderSet.colliders[i]));
+		}
+		colliderSet.grid.build();
+		break;
+	case Broadphase::SweepAndPrune:
+		colliderSet.sweep.clear();
+		for (size_t i = 0; i < colliderSet.colliders.size(); ++i) {
+			colliderSet.sweep.insert(static_cast<unsigned int>(i), colliderSet.entities[i], getBounds(colliderSet.colliders[i]));
+		}
+		colliderSet.sweep.build();
+		break;
+	}
+}
+
+template <typename ColliderType>
+void CollisionSystem::queryCandidates(ColliderSet<ColliderType>& colliderSet, const sf::FloatRect& bounds) {
+	switch (broadphase) {
+	case Broadphase::BruteForce:
+		candidates.resize(colliderSet.colliders.size());
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			candidates[i] = static_cast<unsigned int>(i);
+		}
+		break;
+	case Broadphase::UniformGrid:
+		colliderSet.grid.query(bounds, candidates);
+		break;
+	case Broadphase::SweepAndPrune:
+		colliderSet.sweep.query(bounds, candidates);
+		break;
+	}
+}
+
+void CollisionSystem::computeCircleHits(const ColliderSet<BoxCollider>& boxes, const ColliderSet<CircleCollider>& circles) {
+	size_t words = CollisionKernels::maskWords(boxes.bounds.size());
+	circleHits.resize(words * circles.colliders.size());
+
+	for (size_t j = 0; j < circles.colliders.size(); ++j) {
+		CircleCollider* circle = circles.colliders[j];
+		CollisionKernels::circleVsBoxes(circle->center, circle->radius, boxes.bounds, &circleHits[j * words]);
+	}
+	pairsTested += boxes.bounds.size() * circles.colliders.size();
+}
+
+void CollisionSystem::appendHits(const std::uint64_t* hits, size_t count) {
+	for (size_t word = 0; word < CollisionKernels::maskWords(count); ++word) {
+		for (std::uint64_t bits = hits[word]; bits != 0; bits &= bits - 1) {
+			candidates.push_back(static_cast<unsigned int>(word * 64 + CollisionKernels::lowestBit(bits)));
+		}
+	}
 }
 
 template <typename ColliderType1, typename ColliderType2>
-void CollisionSystem::checkAllCollisions(ComponentManager& manager, sf::RenderWindow& window, const std::vector<Entity::ID>& entities1, const std::vector<Entity::ID>& entities2) {
-	for (auto entity1 : entities1) {
-		if (!manager.isEntityInUse(entity1)) continue;  // Skip inactive entities
+void CollisionSystem::checkAllCollisions(const ColliderSet<ColliderType1>& set1, ColliderSet<ColliderType2>& set2) {
+	constexpr bool boxVsBox = std::is_same<ColliderType1, BoxCollider>::value && std::is_same<ColliderType2, BoxCollider>::value;
+	constexpr bool boxVsCircle = std::is_same<ColliderType1, BoxCollider>::value && std::is_same<ColliderType2, CircleCollider>::value;
+
+	// Nearly every box is tested against the same few circles (the base), so test each circle
+	// against all boxes up front instead of one pair at a time
+	if constexpr (boxVsCircle) {
+		computeCircleHits(set1, set2);
+	}
 
-		ColliderType1* collider1 = manager.getComponent<ColliderType1>(entity1);
-		if (!collider1) continue;  // Ensure collider exists
+	for (size_t i = 0; i < set1.entities.size(); ++i) {
+		Entity::ID entity1 = set1.entities[i];
+		if (claimed[Entity::indexOf(entity1)]) continue;  // Skip entities used up by an earlier collision
+
+		ColliderType1* collider1 = set1.colliders[i];
+
+		// Candidates are always in view order, so the first hit is the same one a full scan would find.
+		// Batch kernels hand back confirmed hits; broadphase candidates still need the narrowphase test.
+		bool confirmed = false;
+		if constexpr (boxVsCircle) {
+			candidates.clear();
+			size_t words = CollisionKernels::maskWords(set1.bounds.size());
+			for (size_t j = 0; j < set2.colliders.size(); ++j) {
+				if ((circleHits[j * words + i / 64] >> (i % 64)) & 1) {
+					candidates.push_back(static_cast<unsigned int>(j));
+				}
+			}
+			confirmed = true;
+		}
+		else if (boxVsBox && broadphase == Broadphase::BruteForce) {
+			boxHits.resize(CollisionKernels::maskWords(set2.bounds.size()));
+			CollisionKernels::boxVsBoxes(getBounds(collider1), set2.bounds, boxHits.data());
+			pairsTested += set2.bounds.size();
+
+			candidates.clear();
+			appendHits(boxHits.data(), set2.bounds.size());
+			confirmed = true;
+		}
+		else {
+			queryCandidates(set2, getBounds(collider1));
+		}
 
-		for (auto entity2 : entities2) {
-			if (entity1 == entity2 || !manager.isEntityInUse(entity2)) continue;  // Skip itself and inactive entities
+		for (unsigned int candidate : candidates) {
+			Entity::ID entity2 = set2.entities[candidate];
+			if (entity1 == entity2 || claimed[Entity::indexOf(entity2)]) continue;  // Skip itself and used up entities
 
-			ColliderType2* collider2 = manager.getComponent<ColliderType2>(entity2);
-			if (collider2 && checkCollision(collider1, collider2)) {
-				// Collision detected
-				handleCollision(manager, window, entity1, entity2);  // Handle the collision between entity1 and entity2
-				break;  // Exit the inner loop after handling collision
+			if (!confirmed) {
+				++pairsTested;
+				if (!checkCollision(collider1, set2.colliders[candidate])) continue;
 			}
+
+			// Collision detected
+			reportCollision(entity1, set1.kinds[i], entity2, set2.kinds[candidate]);
+			break;  // Exit the inner loop after the first collision
 		}
 	}
 }
 
+sf::FloatRect CollisionSystem::getBounds(const BoxCollider* box) {
+	return box->bounds;
+}
+
+sf::FloatRect CollisionSystem::getBounds(const CircleCollider* circle) {
+	return sf::FloatRect(circle->center.x - circle->radius, circle->center.y - circle->radius, circle->radius * 2, circle->radius * 2);
+}
+
 bool CollisionSystem::checkCollision(BoxCollider* box1, BoxCollider* box2) {
 	return box1->bounds.intersects(box2->bounds);
 }
@@ -159,64 +414,15 @@ bool CollisionSystem::checkBoxCircleCollision(BoxCollider* box, CircleCollider*
 	return (dx * dx + dy * dy) <= (circle->radius * circle->radius);
 }
 
-void CollisionSystem::handleCollision(ComponentManager& manager, sf::RenderWindow& window, Entity::ID entity1, Entity::ID entity2) {
-	HealthSystem healthSystem(projectilePool, gameManager);  // Instantiate the HealthSystem to apply damage
+bool CollisionSystem::reportCollision(Entity::ID entity1, EntityKind kind1, Entity::ID entity2, EntityKind kind2) {
+	CollisionResponse response = CollisionTable::lookup(kind1, kind2);
+	if (response.empty()) return false;
 
-	if (manager.getComponent<Velocity>(entity1) && manager.getComponent<Renderable>(entity1)->shape->getFillColor() == sf::Color::Red) {  // Regular projectile collision
-		if (manager.getComponent<Health>(entity2)) {  // Assuming base has Health component
-			healthSystem.applyDamage(manager, entity2, 1);  // Apply damage to base
-		}
-		manager.setEntityInUse(entity1, false);  // Deactivate entity1 (projectile)
-		projectilePool.release(entity1);
-	}
-	else if (manager.getComponent<Velocity>(entity1) && manager.getComponent<Renderable>(entity1)->shape->getFillColor() == sf::Color::Green) {  // Green Power-up collision
-		if (entity2 == 0) {  // Assuming entity2 is the player
-			IncreaseRotationSpeedCommand increaseRotationSpeed;
-			increaseRotationSpeed.execute(manager, 0);  // Execute command to increase rotation speed
-		}
-		manager.setEntityInUse(entity1, false);  // Deactivate the power-up after use
-		projectilePool.release(entity1);
-	}
-	else if (manager.getComponent<Velocity>(entity1) && manager.getComponent<Renderable>(entity1)->shape->getFillColor() == sf::Color::Magenta) {  // Magenta Power-up collision
-		if (entity2 == 0) {  // Assuming entity2 is the player
-			Renderable* playerRender = manager.getComponent<Renderable>(0);  // Assuming player entity ID is 0
-			if (playerRender) {
-				playerRender->shape->setScale(1.5f * playerRender->shape->getScale().x, 1.5f * playerRender->shape->getScale().y);  // Increase diameter by 1.5x
-			}
-			scalePlayerRotation(manager, window);
-			scalePlayerCollider(manager);
-		}
-		manager.setEntityInUse(entity1, false);  // Deactivate the power-up after use
-		projectilePool.release(entity1);
-	}
-	// Handle entity2 as well
-	if (manager.getComponent<Velocity>(entity2) && manager.getComponent<Renderable>(entity2)->shape->getFillColor() == sf::Color::Red) {
-		if (manager.getComponent<Health>(entity1)) {
-			healthSystem.applyDamage(manager, entity1, 1);
-		}
-		manager.setEntityInUse(entity2, false);
-		projectilePool.release(entity2);
-	}
-	else if (manager.getComponent<Velocity>(entity2) && manager.getComponent<Renderable>(entity2)->shape->getFillColor() == sf::Color::Green) {
-		if (entity1 == 0) {
-			IncreaseRotationSpeedCommand increaseRotationSpeed;
-			increaseRotationSpeed.execute(manager, 0);
-		}
-		manager.setEntityInUse(entity2, false);
-		projectilePool.release(entity2);
-	}
-	else if (manager.getComponent<Velocity>(entity2) && manager.getComponent<Renderable>(entity2)->shape->getFillColor() == sf::Color::Magenta) {
-		if (entity1 == 0) {
-			Renderable* playerRender = manager.getComponent<Renderable>(0);  // Assuming player entity ID is 0
-			if (playerRender) {
-				playerRender->shape->setScale(1.5f * playerRender->shape->getScale().x, 1.5f * playerRender->shape->getScale().y);  // Increase diameter by 1.5x
-			}
-			scalePlayerRotation(manager, window);
-			scalePlayerCollider(manager);
-		}
-		manager.setEntityInUse(entity2, false);
-		projectilePool.release(entity2);
-	}
+	// Projectiles and power-ups only react to their first collision
+	claimed[Entity::indexOf(entity1)] = (response.a & Despawn) != 0;
+	claimed[Entity::indexOf(entity2)] = (response.b & Despawn) != 0;
+	events.push(CollisionEvent{ entity1, entity2, response });
+	return true;
 }
 
 void CollisionSystem::scalePlayerCollider(ComponentManager& manager) {
@@ -254,86 +460,56 @@ void CollisionSystem::scalePlayerCollider(ComponentManager& manager) {
 	}
 }
 
-void CollisionSystem::scalePlayerRotation(ComponentManager& manager, sf::RenderWindow& window) {
-	Entity::ID playerId = 0;  // Assuming player entity ID is 0
-
-	Rotation* playerRotation = manager.getComponent<Rotation>(playerId);
-	Renderable* playerRender = manager.getComponent<Renderable>(playerId);
-	BoxCollider* playerBoxCollider = manager.getComponent<BoxCollider>(playerId);
-	CircleCollider* playerCircleCollider = manager.getComponent<CircleCollider>(playerId);
-
-	if (playerRender) {
-		// Retrieve the global bounds of the player shape
-		sf::FloatRect bounds = playerRender->shape->getLocalBounds();//getGlobalBounds();
-
-		// Update BoxCollider if it exists
-		if (playerBoxCollider) {
-			// Update rotation centre based on new size for a box
-			playerRotation->centerX = window.getSize().x / 2 - playerBoxCollider->bounds.width * 3 / 4;
-			playerRotation->centerY = window.getSize().y / 2 - playerBoxCollider->bounds.height * 3 / 4;
-
-			// Update minimum rotation radius based on the largest dimension
-			playerRotation->minRadius = dynamic_cast<sf::CircleShape*>(manager.getComponent<Renderable>(1)->shape)->getRadius()
-				+ playerBoxCollider->bounds.width * 3 / 4;
-		}
-
-		// Update CircleCollider if it exists
-		if (playerCircleCollider) {
-			// Update the circle collider's centre
-			playerCircleCollider->center.x = bounds.left + bounds.width / 2;
-			playerCircleCollider->center.y = bounds.top + bounds.height / 2;
-
-			// Update rotation centre based on new size for a circle
-			playerRotation->centerX = playerCircleCollider->center.x;
-			playerRotation->centerY = playerCircleCollider->center.y;
-		}
-	}
-}
-
-void ProjectileSpawnSystem::update(ComponentManager& manager, sf::RenderWindow& window, float deltaTime) {
+void ProjectileSpawnSystem::update(ComponentManager& manager, const Arena& arena, float deltaTime) {
 	elapsedTime += deltaTime;
 
+	waveKinds.clear();
+	while (elapsedTime >= timeWindow && waveKinds.size() < MaxWave) {
+		elapsedTime -= timeWindow;
+		planSpawn();
+	}
 	if (elapsedTime >= timeWindow) {
-		elapsedTime = 0.f;
-
-		// Generate a random number for power-up spawn
-		std::uniform_int_distribution<> distrib(0, projectilesRemaining - 1);  // Define the range
-		int randomNum = distrib(gen);
-
-		// Decide randomly if we spawn a power-up or a regular projectile
-		if (!powerUpSpawned && randomNum == 0) {  // First projectile of the level TESTTESTTEST
-			spawnPowerUp(manager, window);
-		}
-		else {
-			spawnProjectile(manager, window);
-		}
-
-		projectilesRemaining--;
-
-		// Check if it's time to reduce the time window (i.e., move to the next level)
-		if (projectilesRemaining == 0) {
-			nextLevel();
+		elapsedTime = 0.f;  // A backlog this big means a stall; drop it rather than spawn it later
+	}
+	if (waveKinds.empty()) return;
+
+	fillEdgePositions(arena, waveKinds.size());
+	for (size_t i = 0; i < waveKinds.size(); ++i) {
+		switch (waveKinds[i]) {
+		case EntityKind::SpeedPowerUp:
+			launchSpeedPowerUp(manager, arena, wavePositions[i]);  // Green power-up
+			LOG_DEBUG("Power-up spawned!");
+			break;
+		case EntityKind::SizePowerUp:
+			launchSizePowerUp(manager, arena, wavePositions[i]);  // Magenta power-up
+			LOG_DEBUG("Power-up spawned!");
+			break;
+		default:
+			launchProjectile(manager, arena, wavePositions[i]);
+			LOG_DEBUG("Projectile spawned!");
+			break;
 		}
 	}
 }
 
-void ProjectileSpawnSystem::spawnPowerUp(ComponentManager& manager, sf::RenderWindow& window) {
-	// Randomly choose between speed or size power-up
-	std::uniform_int_distribution<> distrib(0, 1);
-	int powerUpType = distrib(gen);
-	if (powerUpType == 0) {
-		launchSpeedPowerUp(manager, window);  // Green power-up
+// Add the next spawn of the level to the wave
+void ProjectileSpawnSystem::planSpawn() {
+	// Decide randomly if we spawn a power-up or a regular projectile, at most one power-up a level
+	if (!powerUpSpawned && random.below(projectilesRemaining) == 0) {
+		// Randomly choose between speed or size power-up
+		waveKinds.push_back(random.below(2) == 0 ? EntityKind::SpeedPowerUp : EntityKind::SizePowerUp);
+		powerUpSpawned = true;
 	}
 	else {
-		launchSizePowerUp(manager, window);  // Magenta power-up
+		waveKinds.push_back(EntityKind::Projectile);
 	}
-	powerUpSpawned = true;
-	std::cout << "Power-up spawned!" << std::endl;  // Debug message
-}
 
-void ProjectileSpawnSystem::spawnProjectile(ComponentManager& manager, sf::RenderWindow& window) {
-	launchProjectile(manager, window);
-	std::cout << "Projectile spawned!" << std::endl;  // Debug message
+	projectilesRemaining--;
+
+	// Check if it's time to reduce the time window (i.e., move to the next level)
+	if (projectilesRemaining == 0) {
+		nextLevel();
+	}
 }
 
 void ProjectileSpawnSystem::nextLevel() {
@@ -345,22 +521,34 @@ void ProjectileSpawnSystem::nextLevel() {
 	projectilesRemaining = totalProjectiles;  // Reset projectile count for the next level
 }
 
-void ProjectileSpawnSystem::launchProjectile(ComponentManager& manager, sf::RenderWindow& window) {
-	Entity* projectile = projectilePool.acquire();
-	if (!projectile) return;
+// A random point on the arena's edge for each of the first count spawns of the wave, from two
+// draws each: the top two bits of one pick the edge, the other the distance along it
+void ProjectileSpawnSystem::fillEdgePositions(const Arena& arena, size_t count) {
+	waveDraws.resize(count * 2);
+	wavePositions.resize(count);
+	random.fill(waveDraws.data(), waveDraws.size());
+
+	for (size_t i = 0; i < count; ++i) {
+		float along = Random::toUnit(waveDraws[i * 2 + 1]);
+		switch (waveDraws[i * 2] >> 30) {
+		case 0: wavePositions[i] = sf::Vector2f(along * arena.width, 0); break;  // Top edge
+		case 1: wavePositions[i] = sf::Vector2f(arena.width, along * arena.height); break;  // Right edge
+		case 2: wavePositions[i] = sf::Vector2f(along * arena.width, arena.height); break;  // Bottom edge
+		default: wavePositions[i] = sf::Vector2f(0, along * arena.height); break;  // Left edge
+		}
+	}
+}
 
-	// Correctly use manager instead of componentManager
-	manager.removeComponent<Transform>(projectile->getId());
-	manager.removeComponent<Velocity>(projectile->getId());
-	manager.removeComponent<Renderable>(projectile->getId());
-	manager.removeComponent<BoxCollider>(projectile->getId());
+void ProjectileSpawnSystem::launchProjectile(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition) {
+	Entity* projectile = projectilePool.acquire();
+	if (!projectile) return;  // Pool at its high-water mark, counted in getExhaustionCount
 
 	// Initialize the projectile with new components
-	sf::Vector2f spawnPosition = getRandomEdgePosition(window);
 	manager.addComponent<Transform>(projectile->getId(), Transform(spawnPosition.x, spawnPosition.y, 0.f));
+	manager.addComponent<PreviousTransform>(projectile->getId(), PreviousTransform(spawnPosition.x, spawnPosition.y, 0.f));
 
-	float centerX = window.getSize().x / 2.f;
-	float centerY = window.getSize().y / 2.f;
+	float centerX = arena.width / 2.f;
+	float centerY = arena.height / 2.f;
 	float dx = centerX - spawnPosition.x;
 	float dy = centerY - spawnPosition.y;
 	float magnitude = std::sqrt(dx * dx + dy * dy);
@@ -368,45 +556,23 @@ void ProjectileSpawnSystem::launchProjectile(ComponentManager& manager, sf::Rend
 	// Set velocity towards the center
 	manager.addComponent<Velocity>(projectile->getId(), Velocity((dx / magnitude) * 100.f, (dy / magnitude) * 100.f));
 
-	sf::CircleShape* shape = new sf::CircleShape(5.f);
-	shape->setFillColor(sf::Color::Red);
+	sf::CircleShape* shape = Shapes::prototype(EntityKind::Projectile);
 	manager.addComponent<Renderable>(projectile->getId(), Renderable(shape));
+	manager.addComponent<Tag>(projectile->getId(), Tag(EntityKind::Projectile));
 	manager.addComponent<BoxCollider>(projectile->getId(), BoxCollider(spawnPosition.x, spawnPosition.y, shape->getRadius() * 2, shape->getRadius() * 2));
 }
 
-sf::Vector2f ProjectileSpawnSystem::getRandomEdgePosition(sf::RenderWindow& window) {
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-	static std::uniform_real_distribution<> disX(0, window.getSize().x);
-	static std::uniform_real_distribution<> disY(0, window.getSize().y);
-
-	int edge = rand() % 4;
-	switch (edge) {
-	case 0: return sf::Vector2f(disX(gen), 0);  // Top edge
-	case 1: return sf::Vector2f(window.getSize().x, disY(gen));  // Right edge
-	case 2: return sf::Vector2f(disX(gen), window.getSize().y);  // Bottom edge
-	case 3: return sf::Vector2f(0, disY(gen));  // Left edge
-	}
-	return sf::Vector2f(0, 0);  // Default case
-}
-
-void ProjectileSpawnSystem::launchSpeedPowerUp(ComponentManager& manager, sf::RenderWindow& window) {
+void ProjectileSpawnSystem::launchSpeedPowerUp(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition) {
 	Entity* powerUp = projectilePool.acquire();
-	if (!powerUp) return;
-
-	// Clear existing components for the reused power-up
-	manager.removeComponent<Transform>(powerUp->getId());
-	manager.removeComponent<Velocity>(powerUp->getId());
-	manager.removeComponent<Renderable>(powerUp->getId());
-	manager.removeComponent<BoxCollider>(powerUp->getId());
+	if (!powerUp) return;  // Pool at its high-water mark, counted in getExhaustionCount
 
 	// Initialize the power-up with new components
-	sf::Vector2f spawnPosition = getRandomEdgePosition(window);
 	manager.addComponent<Transform>(powerUp->getId(), Transform(spawnPosition.x, spawnPosition.y, 0.f));
+	manager.addComponent<PreviousTransform>(powerUp->getId(), PreviousTransform(spawnPosition.x, spawnPosition.y, 0.f));
 
 	// Set a slower velocity for the power-up towards the center
-	float centerX = window.getSize().x / 2.f;
-	float centerY = window.getSize().y / 2.f;
+	float centerX = arena.width / 2.f;
+	float centerY = arena.height / 2.f;
 	float dx = centerX - spawnPosition.x;
 	float dy = centerY - spawnPosition.y;
 	float magnitude = std::sqrt(dx * dx + dy * dy);
@@ -414,29 +580,23 @@ void ProjectileSpawnSystem::launchSpeedPowerUp(ComponentManager& manager, sf::Re
 	// Set velocity towards the center (slower speed for power-up)
 	manager.addComponent<Velocity>(powerUp->getId(), Velocity((dx / magnitude) * 50.f, (dy / magnitude) * 50.f));
 
-	sf::CircleShape* shape = new sf::CircleShape(5.f);
-	shape->setFillColor(sf::Color::Green);  // Different colour for power-up
+	sf::CircleShape* shape = Shapes::prototype(EntityKind::SpeedPowerUp);
 	manager.addComponent<Renderable>(powerUp->getId(), Renderable(shape));
+	manager.addComponent<Tag>(powerUp->getId(), Tag(EntityKind::SpeedPowerUp));
 	manager.addComponent<BoxCollider>(powerUp->getId(), BoxCollider(spawnPosition.x, spawnPosition.y, shape->getRadius() * 2, shape->getRadius() * 2));
 }
 
-void ProjectileSpawnSystem::launchSizePowerUp(ComponentManager& manager, sf::RenderWindow& window) {
+void ProjectileSpawnSystem::launchSizePowerUp(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition) {
 	Entity* powerUp = projectilePool.acquire();
-	if (!powerUp) return;
-
-	// Clear existing components for the reused power-up
-	manager.removeComponent<Transform>(powerUp->getId());
-	manager.removeComponent<Velocity>(powerUp->getId());
-	manager.removeComponent<Renderable>(powerUp->getId());
-	manager.removeComponent<BoxCollider>(powerUp->getId());
+	if (!powerUp) return;  // Pool at its high-water mark, counted in getExhaustionCount
 
 	// Initialize the power-up with new components
-	sf::Vector2f spawnPosition = getRandomEdgePosition(window);
 	manager.addComponent<Transform>(powerUp->getId(), Transform(spawnPosition.x, spawnPosition.y, 0.0f));
+	manager.addComponent<PreviousTransform>(powerUp->getId(), PreviousTransform(spawnPosition.x, spawnPosition.y, 0.0f));
 
 	// Set a slower velocity for the power-up towards the center
-	float centerX = window.getSize().x / 2.0f;
-	float centerY = window.getSize().y / 2.0f;
+	float centerX = arena.width / 2.0f;
+	float centerY = arena.height / 2.0f;
 	float dx = centerX - spawnPosition.x;
 	float dy = centerY - spawnPosition.y;
 	float magnitude = std::sqrt(dx * dx + dy * dy);
@@ -444,17 +604,20 @@ void ProjectileSpawnSystem::launchSizePowerUp(ComponentManager& manager, sf::Ren
 	// Set velocity towards the center (slower speed for power-up)
 	manager.addComponent<Velocity>(powerUp->getId(), Velocity((dx / magnitude) * 50.0f, (dy / magnitude) * 50.0f));
 
-	sf::CircleShape* shape = new sf::CircleShape(5.f);
-	shape->setFillColor(sf::Color::Magenta);  // Different color for magenta power-up
+	sf::CircleShape* shape = Shapes::prototype(EntityKind::SizePowerUp);
 	manager.addComponent<Renderable>(powerUp->getId(), Renderable(shape));
+	manager.addComponent<Tag>(powerUp->getId(), Tag(EntityKind::SizePowerUp));
 	manager.addComponent<BoxCollider>(powerUp->getId(), BoxCollider(spawnPosition.x, spawnPosition.y, shape->getRadius() * 2, shape->getRadius() * 2));
 }
 
 void ProjectileSpawnSystem::reset(ComponentManager& manager) {
-	std::cout << "Resetting Projectile Spawn System..." << std::endl;
-	auto entitiesWithVelocity = manager.getEntitiesWithComponents<Velocity>();
-	for (auto entity : entitiesWithVelocity) {
-		manager.setEntityInUse(entity, false);  // Deactivate all projectiles
+	LOG_INFO("Resetting Projectile Spawn System...");
+	// Destroying an entity removes it from the view, so keep taking the first until it's empty;
+	// no copy of the list, so a game over doesn't allocate
+	auto& projectiles = manager.view<Velocity>();
+	while (!projectiles.empty()) {
+		Entity::ID entity = std::get<0>(*projectiles.begin());
+		manager.destroyEntity(entity);  // Deactivate all projectiles
 		projectilePool.release(entity);  // Correctly release the entity back to the pool
 	}
 	timeWindow = initialTimeWindow;  // Reset time window to initial value
@@ -470,28 +633,108 @@ void HealthSystem::applyDamage(ComponentManager& manager, Entity::ID entity, int
 	if (health) {
 		health->currentHealth -= damage;
 
-		std::cout << "Damage applied to entity " << entity << ": -" << damage << " health. Current Health: " << health->currentHealth << std::endl;
+		LOG_INFO("Damage applied to entity {}: -{} health. Current Health: {}", entity, damage, health->currentHealth);
 	}
 }
 
-void HealthSystem::update(ComponentManager& manager, sf::RenderWindow& window) {
-	auto entities = manager.getEntitiesWithComponents<Health>();
-
-	for (auto entity : entities) {
+void HealthSystem::update(ComponentManager& manager, const Arena& arena) {
+	for (auto [entity, health] : manager.view<Health>()) {
 		if (!manager.isEntityInUse(entity)) continue;
 
-		Health* health = manager.getComponent<Health>(entity);
-
-		if (health && health->currentHealth <= 0) {
+		if (health->currentHealth <= 0) {
 			// If health is 0 or less, it's game over.
-			gameManager.onBaseHealthDepleted(manager, window);
+			gameManager.onBaseHealthDepleted(manager, arena);
 			break; // Exit after resetting the game.
 		}
 	}
 }
 
-void GameManager::resetGame(ComponentManager& manager, sf::RenderWindow& window) {
-	std::cout << "Game Over! Resetting game..." << std::endl;
+void DamageSystem::update(ComponentManager& manager, const CollisionEventQueue& events) {
+	events.each([&](const CollisionEvent& event) {
+		if (event.response.a & TakeDamage) {
+			healthSystem.applyDamage(manager, event.a, 1);
+		}
+		if (event.response.b & TakeDamage) {
+			healthSystem.applyDamage(manager, event.b, 1);
+		}
+	});
+}
+
+void PowerUpSystem::update(ComponentManager& manager, const Arena& arena, const CollisionEventQueue& events) {
+	events.each([&](const CollisionEvent& event) {
+		applyPowerUp(manager, arena, event.a, event.response.a);
+		applyPowerUp(manager, arena, event.b, event.response.b);
+	});
+}
+
+void PowerUpSystem::applyPowerUp(ComponentManager& manager, const Arena& arena, Entity::ID player, std::uint8_t effect) {
+	if (effect & SpeedUp) {  // Green Power-up collision
+		IncreaseRotationSpeedCommand increaseRotationSpeed;
+		increaseRotationSpeed.execute(manager, player);  // Execute command to increase rotation speed
+	}
+	if (effect & SizeUp) {  // Magenta Power-up collision
+		Renderable* playerRender = manager.getComponent<Renderable>(player);
+		if (playerRender) {
+			playerRender->shape->setScale(1.5f * playerRender->shape->getScale().x, 1.5f * playerRender->shape->getScale().y);  // Increase diameter by 1.5x
+		}
+		scalePlayerRotation(manager, arena);
+		collisionSystem.scalePlayerCollider(manager);
+	}
+}
+
+void PowerUpSystem::scalePlayerRotation(ComponentManager& manager, const Arena& arena) {
+	Entity::ID playerId = 0;  // Assuming player entity ID is 0
+
+	Rotation* playerRotation = manager.getComponent<Rotation>(playerId);
+	Renderable* playerRender = manager.getComponent<Renderable>(playerId);
+	BoxCollider* playerBoxCollider = manager.getComponent<BoxCollider>(playerId);
+	CircleCollider* playerCircleCollider = manager.getComponent<CircleCollider>(playerId);
+
+	if (playerRender) {
+		// Retrieve the global bounds of the player shape
+		sf::FloatRect bounds = playerRender->shape->getLocalBounds();//getGlobalBounds();
+
+		// Update BoxCollider if it exists
+		if (playerBoxCollider) {
+			// Update rotation centre based on new size for a box
+			playerRotation->centerX = arena.width / 2 - playerBoxCollider->bounds.width * 3 / 4;
+			playerRotation->centerY = arena.height / 2 - playerBoxCollider->bounds.height * 3 / 4;
+
+			// Update minimum rotation radius based on the largest dimension
+			playerRotation->minRadius = static_cast<sf::CircleShape*>(manager.getComponent<Renderable>(1)->shape)->getRadius()
+				+ playerBoxCollider->bounds.width * 3 / 4;
+		}
+
+		// Update CircleCollider if it exists
+		if (playerCircleCollider) {
+			// Update the circle collider's centre
+			playerCircleCollider->center.x = bounds.left + bounds.width / 2;
+			playerCircleCollider->center.y = bounds.top + bounds.height / 2;
+
+			// Update rotation centre based on new size for a circle
+			playerRotation->centerX = playerCircleCollider->center.x;
+			playerRotation->centerY = playerCircleCollider->center.y;
+		}
+	}
+}
+
+void DespawnSystem::update(ComponentManager& manager, CollisionEventQueue& events) {
+	events.each([&](const CollisionEvent& event) {
+		despawn(manager, event.a, event.response.a);
+		despawn(manager, event.b, event.response.b);
+	});
+	events.pop(events.size());  // Every resolver has seen this batch
+}
+
+void DespawnSystem::despawn(ComponentManager& manager, Entity::ID entity, std::uint8_t effect) {
+	if (!(effect & Despawn) || !projectilePool.isValid(entity)) return;  // Skip handles recycled since detection
+
+	manager.destroyEntity(entity);  // Deactivate the projectile or power-up after use
+	projectilePool.release(entity);
+}
+
+void GameManager::resetGame(ComponentManager& manager, const Arena& arena) {
+	LOG_INFO("Game Over! Resetting game...");
 
 	// Reset player
 	Entity::ID playerEntity = 0;
@@ -503,19 +746,19 @@ void GameManager::resetGame(ComponentManager& manager, sf::RenderWindow& window)
 	Rotation* playerRotation = manager.getComponent<Rotation>(playerEntity);
 	if (playerRotation && playerRender) {
 		// Cast shape to sf::CircleShape and calculate new positions
-		sf::CircleShape* circleShape = dynamic_cast<sf::CircleShape*>(playerRender->shape);
+		sf::CircleShape* circleShape = static_cast<sf::CircleShape*>(playerRender->shape);
 		if (circleShape) {
 			float radius = circleShape->getRadius();
-			float x = window.getSize().x / 2 - radius;
-			float y = window.getSize().y / 2 - radius;
-			float maxRadius = window.getSize().x / 2 - radius;
+			float x = arena.width / 2 - radius;
+			float y = arena.height / 2 - radius;
+			float maxRadius = arena.width / 2 - radius;
 
 			// Update existing Rotation component
-			playerRotation->angle = 0.f;
+			playerRotation->setAngle(0.f);
 			playerRotation->speed = playerRotation->startSpeed;
 			playerRotation->centerX = x;
 			playerRotation->centerY = y;
-			playerRotation->radius = window.getSize().x / 4;
+			playerRotation->radius = arena.width / 4;
 			playerRotation->maxRadius = maxRadius;
 			playerRotation->clockwise = true;
 		}
@@ -529,8 +772,8 @@ void GameManager::resetGame(ComponentManager& manager, sf::RenderWindow& window)
 	}
 
 	if (playerRotation && playerRender) {
-		sf::CircleShape* baseShape = dynamic_cast<sf::CircleShape*>(manager.getComponent<Renderable>(baseEntity)->shape);
-		sf::CircleShape* playerShape = dynamic_cast<sf::CircleShape*>(playerRender->shape);
+		sf::CircleShape* baseShape = static_cast<sf::CircleShape*>(manager.getComponent<Renderable>(baseEntity)->shape);
+		sf::CircleShape* playerShape = static_cast<sf::CircleShape*>(playerRender->shape);
 		if (baseShape && playerShape) {
 			playerRotation->minRadius = baseShape->getRadius() + playerShape->getRadius();
 		}
@@ -539,12 +782,9 @@ void GameManager::resetGame(ComponentManager& manager, sf::RenderWindow& window)
 	// Reset the projectile spawn system's time window
 	projectileSpawnSystem.reset(manager);
 	collisionSystem.scalePlayerCollider(manager);
-
-	// Reset the game window or any other game-specific logic
-	window.clear();
 }
 
-void GameManager::onBaseHealthDepleted(ComponentManager& manager, sf::RenderWindow& window) {
+void GameManager::onBaseHealthDepleted(ComponentManager& manager, const Arena& arena) {
 	// When base health is 0, reset the game
-	resetGame(manager, window);
+	resetGame(manager, arena);
 }
\ No newline at end of file
@@ -1,57 +1,164 @@
 #ifndef SYSTEMS_H
 #define SYSTEMS_H
 
+#include "Arena.h"
 #include "ComponentManager.h"
 #include "ObjectPool.h"
+#include "CollisionEvents.h"
+#include "CollisionKernels.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include "Random.h"
 #include <SFML/Graphics.hpp>
-#include <random>
+#include <vector>
 
+// Moves entities with a Velocity and keeps their BoxCollider on their new position
 class MovementSystem {
 public:
     void update(ComponentManager& manager, float deltaTime);
+
+    // Split the sweep across scheduler's threads; nullptr keeps it on the calling thread
+    void setScheduler(JobScheduler* jobScheduler) { scheduler = jobScheduler; }
+
+private:
+    JobScheduler* scheduler = nullptr;
 };
 
+// Moves entities with a Rotation round their orbit. Entities with a Velocity are skipped, so
+// this never touches what MovementSystem does and the two can run at the same time.
 class RotationSystem {
 public:
     void update(ComponentManager& manager, float deltaTime);
+
+    // Ticks between re-deriving each direction from its angle, which undoes the drift the
+    // repeated multiply builds up. Entities are staggered so only a few re-derive per tick.
+    static constexpr unsigned int ResyncInterval = 64;
+
+private:
+    unsigned int ticks = 0;
+};
+
+// Copies each Transform into its PreviousTransform. Runs first in every simulation tick.
+class SnapshotSystem {
+public:
+    void update(ComponentManager& manager);
 };
 
+// Draws the player and base shape by shape. Everything drawn with a shared Shapes.h prototype,
+// meaning projectiles and power-ups, is written into one vertex array and drawn in a single call.
 class RenderSystem {
 public:
-    void render(ComponentManager& manager, sf::RenderWindow& window);
+    RenderSystem();
+
+    // alpha is how far the frame is between the last two simulation ticks, from 0 to 1.
+    // Entities with a PreviousTransform are drawn that far from it towards their Transform.
+    void render(ComponentManager& manager, sf::RenderWindow& window, float alpha = 1.f);
+
+private:
+    // A prototype and its outline relative to the shape's origin, read once at construction
+    struct CircleBatch {
+        const sf::CircleShape* prototype;
+        std::vector<sf::Vector2f> points;
+    };
+
+    void appendCircle(const CircleBatch& batch, const Transform& transform);
+
+    std::vector<CircleBatch> batches;  // One per kind with a prototype
+    sf::VertexArray circles;  // Rebuilt every frame; clearing keeps its capacity
 };
 
 class GameManager;
 
+// Finds colliding pairs and reports them as CollisionEvents. Detection leaves the game state
+// untouched; DamageSystem, PowerUpSystem and DespawnSystem resolve the events afterwards.
 class CollisionSystem {
 public:
-    CollisionSystem(ObjectPool& projectilePool, GameManager& gameManager)
-        : projectilePool(projectilePool),  gameManager(gameManager) {}
+    // How candidate pairs are found before the narrowphase; every mode reports the same collisions
+    enum class Broadphase {
+        BruteForce,  // Test every pair
+        UniformGrid,  // SpatialHash rebuilt each frame
+        SweepAndPrune  // Sorted x intervals kept between frames
+    };
 
-    void update(ComponentManager& manager, sf::RenderWindow& window);
+    void update(ComponentManager& manager);
     void scalePlayerCollider(ComponentManager& manager);
 
+    // Events from the last update that the resolvers haven't consumed yet
+    CollisionEventQueue& getEvents() { return events; }
+
+    void setBroadphase(Broadphase mode) { broadphase = mode; }
+
+    // Split the BoxCollider sync across scheduler's threads; nullptr keeps it on the calling thread
+    void setScheduler(JobScheduler* jobScheduler) { scheduler = jobScheduler; }
+    Broadphase getBroadphase() const { return broadphase; }
+
+    // Narrowphase tests run during the last update
+    size_t getPairsTested() const { return pairsTested; }
+
 private:
-    ObjectPool& projectilePool;
-    GameManager& gameManager;
+    // Broadphase grid cells match the projectile BoxCollider (5px radius shape)
+    static constexpr float ProjectileColliderSize = 10.f;
+
+    // Active colliders of one type gathered for the current frame, plus the broadphase over their bounds
+    template <typename ColliderType>
+    struct ColliderSet {
+        std::vector<Entity::ID> entities;
+        std::vector<ColliderType*> colliders;
+        std::vector<EntityKind> kinds;
+        SpatialHash grid{ ProjectileColliderSize };
+        SweepAndPrune sweep;
+        BoxArrays bounds;  // Packed copy of the box bounds for the batch kernels, empty for circle sets
+    };
+
+    ColliderSet<BoxCollider> boxColliders;
+    ColliderSet<CircleCollider> circleColliders;
+    std::vector<unsigned int> candidates;  // Reused broadphase query result
+    std::vector<std::uint64_t> boxHits;  // Batch kernel result for one box against every box
+    std::vector<std::uint64_t> circleHits;  // Batch kernel results, one mask over every box per circle
+    Broadphase broadphase = Broadphase::UniformGrid;
+    JobScheduler* scheduler = nullptr;
+    size_t pairsTested = 0;
+
+    CollisionEventQueue events;
+    std::vector<bool> claimed;  // Per entity index, already used up by an event this frame
+
+    // Rebuild a collider set and its broadphase from a view
+    template <typename ColliderView, typename ColliderType>
+    void gatherColliders(ComponentManager& manager, const ColliderView& view, ColliderSet<ColliderType>& colliderSet);
+
+    // Reinsert a set's colliders at their current bounds
+    template <typename ColliderType>
+    void rebuildBroadphase(ColliderSet<ColliderType>& colliderSet);
+
+    // Indices into colliderSet that may overlap the bounds, in ascending order
+    template <typename ColliderType>
+    void queryCandidates(ColliderSet<ColliderType>& colliderSet, const sf::FloatRect& bounds);
+
+    // Test every circle against every box in one batch per circle, filling circleHits
+    void computeCircleHits(const ColliderSet<BoxCollider>& boxes, const ColliderSet<CircleCollider>& circles);
 
-    // General collision detection function
+    // Append the set bits of a hit mask to candidates, in ascending order
+    void appendHits(const std::uint64_t* hits, size_t count);
+
+    // General collision detection function, tests each collider in set1 against its broadphase candidates in set2
     template <typename ColliderType1, typename ColliderType2>
-    void checkAllCollisions(ComponentManager& manager, sf::RenderWindow& window, const std::vector<Entity::ID>& entities1, const std::vector<Entity::ID>& entities2);
+    void checkAllCollisions(const ColliderSet<ColliderType1>& set1, ColliderSet<ColliderType2>& set2);
+
+    // Axis-aligned bounds used by the broadphase
+    static sf::FloatRect getBounds(const BoxCollider* box);
+    static sf::FloatRect getBounds(const CircleCollider* circle);
 
     // Specific collision detection functions
     bool checkCollision(BoxCollider* box1, BoxCollider* box2);
     bool checkCollision(BoxCollider* box, CircleCollider* circle);
     bool checkCollision(CircleCollider* circle1, CircleCollider* circle2);
 
-    // Handle the collision between two entities
-    void handleCollision(ComponentManager& manager, sf::RenderWindow& window, Entity::ID entity1, Entity::ID entity2);
+    // Queue an event for the pair and claim the entities it uses up; false if nothing would happen
+    bool reportCollision(Entity::ID entity1, EntityKind kind1, Entity::ID entity2, EntityKind kind2);
 
     // Function to check collision between a box and a circle
     bool checkBoxCircleCollision(BoxCollider* box, CircleCollider* circle);
 
-    void scalePlayerRotation(ComponentManager& manager, sf::RenderWindow& window);
-
     // Utility function for clamping values
     template <typename T>
     static T clamp(const T& value, const T& min, const T& max) {
@@ -59,23 +166,34 @@ private:
     }
 };
 
+// Draws every random choice from the generator it is given, so a seeded generator makes the
+// spawn sequence repeatable.
+//
+// Each update spawns everything due since the last one as a wave: a long tick, or a late level
+// whose spawn interval is shorter than a tick, can launch hundreds at once. The wave is planned
+// first, then its edge positions come from one batch of random draws.
 class ProjectileSpawnSystem {
 public:
-    ProjectileSpawnSystem(ObjectPool& projectilePool, float initialTimeWindow)
-        : projectilePool(projectilePool), timeWindow(initialTimeWindow), initialTimeWindow(initialTimeWindow),
-        elapsedTime(0.f), level(1), totalProjectiles(10), projectilesRemaining(10),
-        gen(rd())
+    ProjectileSpawnSystem(ObjectPool& projectilePool, Random& random, float initialTimeWindow)
+        : projectilePool(projectilePool), random(random), timeWindow(initialTimeWindow), initialTimeWindow(initialTimeWindow),
+        elapsedTime(0.f), level(1), totalProjectiles(10), projectilesRemaining(10)
     {
         levelTime = totalProjectiles * timeWindow;
+
+        // Room for the largest wave, so a bigger wave than any before doesn't allocate mid-game
+        waveKinds.reserve(MaxWave);
+        waveDraws.reserve(MaxWave * 2);
+        wavePositions.reserve(MaxWave);
     }
 
-    void update(ComponentManager& manager, sf::RenderWindow& window, float deltaTime);
+    void update(ComponentManager& manager, const Arena& arena, float deltaTime);
     void reset(ComponentManager& manager);
 
     int totalSpawned = 0;
 
 private:
     ObjectPool& projectilePool;
+    Random& random;  // Owned by the simulation
     float timeWindow;
     float initialTimeWindow;
     float elapsedTime;
@@ -85,16 +203,19 @@ private:
     float levelTime;
     bool powerUpSpawned = false;
 
-    std::random_device rd;  // Obtain a random number from hardware
-    std::mt19937 gen;  // Declare the generator without initializing it
+    static constexpr size_t MaxWave = 4096;  // Spawns past this in one update are dropped, not carried over
 
-    void spawnPowerUp(ComponentManager& manager, sf::RenderWindow& window);
-    void spawnProjectile(ComponentManager& manager, sf::RenderWindow& window);
+    // The current wave, kept between updates so their storage is reused
+    std::vector<EntityKind> waveKinds;
+    std::vector<Random::result_type> waveDraws;
+    std::vector<sf::Vector2f> wavePositions;
+
+    void planSpawn();
     void nextLevel();
-    void launchProjectile(ComponentManager& manager, sf::RenderWindow& window);
-    void launchSpeedPowerUp(ComponentManager& manager, sf::RenderWindow& window);
-    void launchSizePowerUp(ComponentManager& manager, sf::RenderWindow& window);
-    sf::Vector2f getRandomEdgePosition(sf::RenderWindow& window);
+    void fillEdgePositions(const Arena& arena, size_t count);
+    void launchProjectile(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition);
+    void launchSpeedPowerUp(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition);
+    void launchSizePowerUp(ComponentManager& manager, const Arena& arena, sf::Vector2f spawnPosition);
 };
 
 class HealthSystem {
@@ -102,7 +223,7 @@ public:
     HealthSystem(ObjectPool& projectilePool, GameManager& gameManager)
         : projectilePool(projectilePool), gameManager(gameManager) {}
 
-    void update(ComponentManager& manager, sf::RenderWindow& window);
+    void update(ComponentManager& manager, const Arena& arena);
     void applyDamage(ComponentManager& manager, Entity::ID entity, int damage);
 
 private:
@@ -112,13 +233,52 @@ private:
     void checkBaseHealth(ComponentManager& manager);
 };
 
+// Applies projectile hits to anything with Health
+class DamageSystem {
+public:
+    DamageSystem(HealthSystem& healthSystem) : healthSystem(healthSystem) {}
+
+    void update(ComponentManager& manager, const CollisionEventQueue& events);
+
+private:
+    HealthSystem& healthSystem;
+};
+
+// Applies power-ups collected by the player
+class PowerUpSystem {
+public:
+    PowerUpSystem(CollisionSystem& collisionSystem) : collisionSystem(collisionSystem) {}
+
+    void update(ComponentManager& manager, const Arena& arena, const CollisionEventQueue& events);
+
+private:
+    CollisionSystem& collisionSystem;
+
+    void applyPowerUp(ComponentManager& manager, const Arena& arena, Entity::ID player, std::uint8_t effect);
+    void scalePlayerRotation(ComponentManager& manager, const Arena& arena);
+};
+
+// Returns projectiles and power-ups that hit something to the pool, then pops the events.
+// Runs after every other resolver.
+class DespawnSystem {
+public:
+    DespawnSystem(ObjectPool& projectilePool) : projectilePool(projectilePool) {}
+
+    void update(ComponentManager& manager, CollisionEventQueue& events);
+
+private:
+    ObjectPool& projectilePool;
+
+    void despawn(ComponentManager& manager, Entity::ID entity, std::uint8_t effect);
+};
+
 class GameManager {
 public:
     GameManager(ProjectileSpawnSystem& projectileSystem, CollisionSystem& collisionSystem)
         : projectileSpawnSystem(projectileSystem), collisionSystem(collisionSystem) {}  // Pass reference to systems that need to be reset
 
-    void resetGame(ComponentManager& manager, sf::RenderWindow& window);
-    void onBaseHealthDepleted(ComponentManager& manager, sf::RenderWindow& window);
+    void resetGame(ComponentManager& manager, const Arena& arena);
+    void onBaseHealthDepleted(ComponentManager& manager, const Arena& arena);
 
 private:
     ProjectileSpawnSystem& projectileSpawnSystem;
@@ -0,0 +1,120 @@
+#pragma once
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include "Entity.h"
+#include "ComponentPool.h"
+
+// Type-erased base so the ComponentManager can notify every view when components change
+class IView {
+public:
+    virtual ~IView() = default;
+    virtual void onComponentAdded(Entity::ID entity) = 0;
+    virtual void onComponentRemoved(Entity::ID entity) = 0;
+};
+
+// Persistent query over all entities that have every component in Ts.
+// Created once by ComponentManager::view() and kept up to date as components are added or
+// removed, so iterating it never allocates. Iteration yields (entity, Ts*...) tuples.
+// Removing a component of the viewed types while iterating may skip entities.
+template <typename... Ts>
+class View : public IView {
+public:
+    using value_type = std::tuple<Entity::ID, Ts*...>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = View::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator(const View* view, size_t index) : view(view), index(index) {}
+
+        value_type operator*() const {
+            Entity::ID entity = view->members[index];
+            return value_type(entity, std::get<ComponentPool<Ts>*>(view->pools)->get(entity)...);
+        }
+
+        iterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+
+    private:
+        const View* view;
+        size_t index;
+    };
+
+    explicit View(ComponentPool<Ts>&... componentPools) : pools(&componentPools...) {
+        // Seed from the first pool, then stay current through the add/remove notifications
+        using First = typename std::tuple_element<0, std::tuple<Ts...>>::type;
+        for (Entity::ID entity : std::get<ComponentPool<First>*>(pools)->entities()) {
+            onComponentAdded(entity);
+        }
+    }
+
+    void onComponentAdded(Entity::ID entity) override {
+        if (contains(entity) || !(std::get<ComponentPool<Ts>*>(pools)->has(entity) && ...)) return;
+
+        Entity::ID slot = Entity::indexOf(entity);
+        if (slot >= sparse.size()) {
+            sparse.resize(slot + 1, npos);
+        }
+        sparse[slot] = static_cast<unsigned int>(members.size());
+        members.push_back(entity);
+    }
+
+    void onComponentRemoved(Entity::ID entity) override {
+        if (!contains(entity)) return;
+
+        // Swap the last member into the freed slot
+        unsigned int index = sparse[Entity::indexOf(entity)];
+        Entity::ID last = members.back();
+        members[index] = last;
+        sparse[Entity::indexOf(last)] = index;
+        members.pop_back();
+        sparse[Entity::indexOf(entity)] = npos;
+    }
+
+    bool contains(Entity::ID entity) const {
+        Entity::ID slot = Entity::indexOf(entity);
+        return slot < sparse.size() && sparse[slot] != npos && members[sparse[slot]] == entity;
+    }
+
+    // Call func(entity, Ts&...) for every member
+    template <typename Func>
+    void each(Func func) {
+        for (Entity::ID entity : members) {
+            func(entity, *std::get<ComponentPool<Ts>*>(pools)->get(entity)...);
+        }
+    }
+
+    // each() over members [begin, end) only, so separate threads can take separate ranges
+    template <typename Func>
+    void eachInRange(size_t begin, size_t end, Func func) {
+        for (size_t i = begin; i < end; ++i) {
+            Entity::ID entity = members[i];
+            func(entity, *std::get<ComponentPool<Ts>*>(pools)->get(entity)...);
+        }
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, members.size()); }
+
+    size_t size() const { return members.size(); }
+    bool empty() const { return members.empty(); }
+
+    const std::vector<Entity::ID>& entities() const { return members; }
+
+private:
+    static constexpr unsigned int npos = ~0u;
+
+    std::tuple<ComponentPool<Ts>*...> pools;
+    std::vector<Entity::ID> members;
+    std::vector<unsigned int> sparse;  // Entity index -> index in members
+};
@@ -0,0 +1,127 @@
+// Runs the same projectile wave through CollisionSystem once per broadphase mode and reports
+// narrowphase pairs tested per frame, time per frame, and a hash of the surviving entities.
+// The hash must match across modes, since every broadphase has to report the same collisions.
+//
+// Built by the broadphase_benchmark target in the top-level CMakeLists.txt.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "../Systems.h"
+#include "../Shapes.h"
+
+// Only the systems collision depends on, declared in the same order Game relies on
+struct CollisionScene {
+    Arena arena{ 800.f, 800.f };
+    sf::CircleShape playerShape = Shapes::makeCircle(10.f, sf::Color::Cyan);
+    sf::CircleShape baseShape = Shapes::makeCircle(100.f, sf::Color::White);
+    ComponentManager manager;
+    ObjectPool projectilePool;
+    Random random;
+    ProjectileSpawnSystem projectileSpawnSystem;
+    GameManager gameManager;
+    CollisionSystem collisionSystem;
+    HealthSystem healthSystem;
+    DamageSystem damageSystem;
+    PowerUpSystem powerUpSystem;
+    DespawnSystem despawnSystem;
+    MovementSystem movementSystem;
+    RotationSystem rotationSystem;
+
+    explicit CollisionScene(size_t projectiles)
+        : projectilePool(projectiles),
+        random(1234),
+        projectileSpawnSystem(projectilePool, random, 4.f),
+        gameManager(projectileSpawnSystem, collisionSystem),
+        healthSystem(projectilePool, gameManager),
+        damageSystem(healthSystem),
+        powerUpSystem(collisionSystem),
+        despawnSystem(projectilePool) {}
+};
+
+static void populate(CollisionScene& scene, size_t projectiles) {
+    ComponentManager& manager = scene.manager;
+
+    // Player orbiting the base
+    manager.addComponent<Transform>(0, Transform(0.f, 0.f, 0.f));
+    manager.addComponent<Renderable>(0, Renderable(&scene.playerShape));
+    manager.addComponent<Rotation>(0, Rotation(0.f, 80.f, true, 390.f, 390.f, 200.f, 390.f, 110.f));
+    manager.addComponent<BoxCollider>(0, BoxCollider(390.f, 390.f, 20.f, 20.f));
+    manager.addComponent<Tag>(0, Tag(EntityKind::Player));
+
+    // Base without Health, so hits don't end the run or log
+    manager.addComponent<Renderable>(1, Renderable(&scene.baseShape));
+    manager.addComponent<Transform>(1, Transform(300.f, 300.f, 0.f));
+    manager.addComponent<CircleCollider>(1, CircleCollider(400.f, 400.f, 100.f));
+    manager.addComponent<Tag>(1, Tag(EntityKind::Base));
+
+    // Projectiles scattered over the arena, all heading for the centre
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> position(0.f, 800.f);
+    for (size_t i = 0; i < projectiles; ++i) {
+        Entity* projectile = scene.projectilePool.acquire();
+        float x = position(gen);
+        float y = position(gen);
+        float dx = 400.f - x;
+        float dy = 400.f - y;
+        float magnitude = std::sqrt(dx * dx + dy * dy) + 1e-3f;
+
+        sf::CircleShape* shape = Shapes::prototype(EntityKind::Projectile);
+        manager.addComponent<Transform>(projectile->getId(), Transform(x, y, 0.f));
+        manager.addComponent<Velocity>(projectile->getId(), Velocity(dx / magnitude * 100.f, dy / magnitude * 100.f));
+        manager.addComponent<Renderable>(projectile->getId(), Renderable(shape));
+        manager.addComponent<BoxCollider>(projectile->getId(), BoxCollider(x, y, 10.f, 10.f));
+        manager.addComponent<Tag>(projectile->getId(), Tag(EntityKind::Projectile));
+    }
+}
+
+static void run(const char* name, CollisionSystem::Broadphase mode, size_t projectiles, int frames) {
+    CollisionScene scene(projectiles);
+    populate(scene, projectiles);
+    scene.collisionSystem.setBroadphase(mode);
+
+    const float deltaTime = 1.f / 60.f;
+    size_t pairs = 0;
+    std::chrono::steady_clock::duration collisionTime{};
+
+    for (int frame = 0; frame < frames; ++frame) {
+        scene.movementSystem.update(scene.manager, deltaTime);
+        scene.rotationSystem.update(scene.manager, deltaTime);
+
+        auto start = std::chrono::steady_clock::now();
+        scene.collisionSystem.update(scene.manager);
+        collisionTime += std::chrono::steady_clock::now() - start;
+        pairs += scene.collisionSystem.getPairsTested();
+
+        CollisionEventQueue& events = scene.collisionSystem.getEvents();
+        scene.damageSystem.update(scene.manager, events);
+        scene.powerUpSystem.update(scene.manager, scene.arena, events);
+        scene.despawnSystem.update(scene.manager, events);
+    }
+
+    unsigned long long survivors = 1469598103934665603ull;
+    size_t alive = 0;
+    for (Entity::ID entity = 0; entity < projectiles + 2; ++entity) {
+        if (scene.manager.isEntityInUse(entity)) {
+            survivors = (survivors ^ entity) * 1099511628211ull;
+            ++alive;
+        }
+    }
+
+    double msPerFrame = std::chrono::duration<double, std::milli>(collisionTime).count() / frames;
+    std::printf("%-16s %8zu %14.0f %10.3f %8zu   %016llx\n", name, projectiles, double(pairs) / frames, msPerFrame, alive, survivors);
+}
+
+int main() {
+    const int frames = 120;
+    std::printf("%-16s %8s %14s %10s %8s   %s\n", "broadphase", "entities", "pairs/frame", "ms/frame", "alive", "survivor hash");
+
+    for (size_t projectiles : { 1000u, 4000u, 16000u }) {
+        if (projectiles <= 4000) {  // Quadratic, too slow beyond this
+            run("brute-force", CollisionSystem::Broadphase::BruteForce, projectiles, frames);
+        }
+        run("uniform-grid", CollisionSystem::Broadphase::UniformGrid, projectiles, frames);
+        run("sweep-and-prune", CollisionSystem::Broadphase::SweepAndPrune, projectiles, frames);
+    }
+    return 0;
+}
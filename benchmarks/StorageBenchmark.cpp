@@ -0,0 +1,132 @@
+// Compares the component storage backends at 1k, 10k and 100k projectile-shaped entities:
+//   map        - the original nested unordered_map of heap-allocated components (reproduced below)
+//   sparse-set - SparseSetComponentManager, the default ComponentManager
+//   archetype  - ArchetypeComponentManager (CENTRAL_DEFENCE_ARCHETYPE_STORAGE)
+//
+// Built by the storage_benchmark target in the top-level CMakeLists.txt; only needs the SFML headers.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "../ComponentManager.h"
+
+// The pre-sparse-set storage: one hash map per component type, one heap allocation per component
+class MapComponentManager {
+public:
+    template <typename T>
+    void addComponent(Entity::ID entity, T component) {
+        components[typeid(T)][entity] = std::make_shared<T>(component);
+    }
+
+    template <typename T>
+    void removeComponent(Entity::ID entity) {
+        components[typeid(T)].erase(entity);
+    }
+
+    template <typename T>
+    T* getComponent(Entity::ID entity) {
+        auto& map = components[typeid(T)];
+        auto it = map.find(entity);
+        return (it != map.end()) ? static_cast<T*>(it->second.get()) : nullptr;
+    }
+
+    template <typename T, typename... Others, typename Func>
+    void forEach(Func func) {
+        std::vector<Entity::ID> entities;  // The old query built a fresh vector every call
+        for (auto& pair : components[typeid(T)]) {
+            if ((getComponent<Others>(pair.first) && ...)) {
+                entities.push_back(pair.first);
+            }
+        }
+        for (Entity::ID entity : entities) {
+            func(entity, *getComponent<T>(entity), *getComponent<Others>(entity)...);
+        }
+    }
+
+private:
+    std::unordered_map<std::type_index, std::unordered_map<Entity::ID, std::shared_ptr<void>>> components;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double nsPerEntity(Clock::time_point start, size_t operations) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+template <typename Manager>
+void runBackend(const char* name, size_t count) {
+    Manager manager;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> position(0.f, 800.f);
+
+    // Spawn: the four components a projectile gets in launchProjectile
+    Clock::time_point start = Clock::now();
+    for (Entity::ID entity = 0; entity < count; ++entity) {
+        float x = position(gen);
+        float y = position(gen);
+        manager.template addComponent<Transform>(entity, Transform(x, y, 0.f));
+        manager.template addComponent<Velocity>(entity, Velocity(1.f, -1.f));
+        manager.template addComponent<Renderable>(entity, Renderable());
+        manager.template addComponent<BoxCollider>(entity, BoxCollider(x, y, 10.f, 10.f));
+    }
+    double spawn = nsPerEntity(start, count);
+
+    // Random access, as collision handling does
+    std::vector<Entity::ID> order(count);
+    for (Entity::ID entity = 0; entity < count; ++entity) {
+        order[entity] = entity;
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+
+    float checksum = 0.f;
+    start = Clock::now();
+    for (Entity::ID entity : order) {
+        checksum += manager.template getComponent<Transform>(entity)->x;
+    }
+    double get = nsPerEntity(start, count);
+
+    // MovementSystem-style sweep
+    const int frames = 20;
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        manager.template forEach<Velocity, Transform>([&](Entity::ID, Velocity& velocity, Transform& transform) {
+            transform.x += velocity.dx * 0.016f;
+            transform.y += velocity.dy * 0.016f;
+        });
+    }
+    double sweep = nsPerEntity(start, count * frames);
+
+    // Respawn churn: strip and re-add every component on a tenth of the entities
+    start = Clock::now();
+    size_t churned = 0;
+    for (Entity::ID entity = 0; entity < count; entity += 10, ++churned) {
+        manager.template removeComponent<Transform>(entity);
+        manager.template removeComponent<Velocity>(entity);
+        manager.template removeComponent<Renderable>(entity);
+        manager.template removeComponent<BoxCollider>(entity);
+        manager.template addComponent<Transform>(entity, Transform());
+        manager.template addComponent<Velocity>(entity, Velocity());
+        manager.template addComponent<Renderable>(entity, Renderable());
+        manager.template addComponent<BoxCollider>(entity, BoxCollider());
+    }
+    double churn = nsPerEntity(start, churned);
+
+    std::printf("%-10s %8zu %10.1f %10.1f %10.2f %10.1f   (checksum %.0f)\n",
+        name, count, spawn, get, sweep, churn, checksum);
+}
+
+int main() {
+    std::printf("%-10s %8s %10s %10s %10s %10s\n", "backend", "entities", "spawn", "get", "sweep", "churn");
+    std::printf("%-10s %8s %10s %10s %10s %10s\n", "", "", "ns/entity", "ns/entity", "ns/entity", "ns/entity");
+
+    for (size_t count : { 1000u, 10000u, 100000u }) {
+        runBackend<MapComponentManager>("map", count);
+        runBackend<SparseSetComponentManager>("sparse-set", count);
+        runBackend<ArchetypeComponentManager>("archetype", count);
+    }
+    return 0;
+}
@@ -0,0 +1,420 @@
+// Google Benchmark suite for the ECS core and every simulation system, parameterised on entity count.
+// Each benchmark times one frame of work per iteration and also reports
+//   ns_per_entity    - frame time divided by the entity count
+//   allocs_per_frame - heap allocations made during the timed frame
+// Per-frame setup (refilling pools, clearing queued events) is left out of the measurement.
+//
+// Runs headless on Linux. Built by the system_benchmarks target in the top-level CMakeLists.txt,
+// which needs Google Benchmark installed.
+//
+// JSON for diffing between commits (e.g. with Google Benchmark's tools/compare.py):
+//   ./system_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include "../Log.h"
+#include "../MovementKernels.h"
+#include "../Systems.h"
+
+// Every heap allocation in the process goes through these, so the timed frames can count them
+static std::atomic<size_t> allocationCount{ 0 };
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align)) return memory;
+    throw std::bad_alloc();
+}
+
+// Both operator new overloads above allocate with malloc/aligned_alloc, so free is the matching release
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+
+// Time run() once per iteration, with prepare() run first outside the measurement.
+// One untimed warm-up frame lets views and scratch buffers reach their steady-state size.
+template <typename Prepare, typename Run>
+static void measureFrames(benchmark::State& state, size_t entities, Prepare prepare, Run run) {
+    prepare();
+    run();
+
+    double totalSeconds = 0.0;
+    size_t allocations = 0;
+
+    for (auto _ : state) {
+        prepare();
+
+        size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        state.SetIterationTime(seconds);
+        totalSeconds += seconds;
+    }
+
+    double frames = static_cast<double>(state.iterations());
+    state.counters["ns_per_entity"] = totalSeconds * 1e9 / (frames * entities);
+    state.counters["allocs_per_frame"] = allocations / frames;
+}
+
+template <typename Run>
+static void measureFrames(benchmark::State& state, size_t entities, Run run) {
+    measureFrames(state, entities, [] {}, run);
+}
+
+// Spawning logs every projectile; keep that out of the benchmark output. Messages are still
+// queued, so the cost of logging stays in the timings.
+struct SilenceLog {
+    SilenceLog() { Log::setOutput(nullptr); }
+
+    ~SilenceLog() {
+        Log::flush();
+        Log::setOutput(&std::cout);
+    }
+};
+
+// Player orbiting a base at the centre of the arena, as Game sets them up
+static void addPlayerAndBase(ComponentManager& manager, const Arena& arena) {
+    float centerX = arena.width / 2.f;
+    float centerY = arena.height / 2.f;
+
+    manager.addComponent<Transform>(0, Transform(centerX, centerY, 0.f));
+    manager.addComponent<Rotation>(0, Rotation(0.f, 80.f, true, centerX - 10.f, centerY - 10.f, arena.width / 4.f, arena.width / 2.f, 110.f));
+    manager.addComponent<BoxCollider>(0, BoxCollider(centerX, centerY, 20.f, 20.f));
+    manager.addComponent<Tag>(0, Tag(EntityKind::Player));
+
+    manager.addComponent<Transform>(1, Transform(centerX - 100.f, centerY - 100.f, 0.f));
+    manager.addComponent<CircleCollider>(1, CircleCollider(centerX, centerY, 100.f));
+    manager.addComponent<Tag>(1, Tag(EntityKind::Base));
+}
+
+// Projectiles scattered over the arena, all heading for the centre
+static void addProjectiles(ComponentManager& manager, const Arena& arena, Entity::ID first, size_t count) {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> positionX(0.f, arena.width);
+    std::uniform_real_distribution<float> positionY(0.f, arena.height);
+
+    for (Entity::ID entity = first; entity < first + count; ++entity) {
+        float x = positionX(gen);
+        float y = positionY(gen);
+        float dx = arena.width / 2.f - x;
+        float dy = arena.height / 2.f - y;
+        float magnitude = std::sqrt(dx * dx + dy * dy) + 1e-3f;
+
+        manager.addComponent<Transform>(entity, Transform(x, y, 0.f));
+        manager.addComponent<PreviousTransform>(entity, PreviousTransform(x, y, 0.f));
+        manager.addComponent<Velocity>(entity, Velocity(dx / magnitude * 100.f, dy / magnitude * 100.f));
+        manager.addComponent<BoxCollider>(entity, BoxCollider(x, y, 10.f, 10.f));
+        manager.addComponent<Tag>(entity, Tag(EntityKind::Projectile));
+    }
+}
+
+static void BM_ComponentManagerAdd(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ComponentManager manager;
+
+    measureFrames(state, entities,
+        [&] {
+            for (Entity::ID entity = 0; entity < entities; ++entity) {
+                manager.removeComponent<Transform>(entity);
+            }
+        },
+        [&] {
+            for (Entity::ID entity = 0; entity < entities; ++entity) {
+                manager.addComponent<Transform>(entity, Transform(float(entity), 0.f, 0.f));
+            }
+        });
+}
+
+static void BM_ComponentManagerGet(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ComponentManager manager;
+    for (Entity::ID entity = 0; entity < entities; ++entity) {
+        manager.addComponent<Transform>(entity, Transform(float(entity), 0.f, 0.f));
+    }
+
+    measureFrames(state, entities, [&] {
+        float sum = 0.f;
+        for (Entity::ID entity = 0; entity < entities; ++entity) {
+            sum += manager.getComponent<Transform>(entity)->x;
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+static void BM_ComponentManagerRemove(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ComponentManager manager;
+
+    measureFrames(state, entities,
+        [&] {
+            for (Entity::ID entity = 0; entity < entities; ++entity) {
+                manager.addComponent<Transform>(entity, Transform(float(entity), 0.f, 0.f));
+            }
+        },
+        [&] {
+            for (Entity::ID entity = 0; entity < entities; ++entity) {
+                manager.removeComponent<Transform>(entity);
+            }
+        });
+}
+
+// Half the entities have a Velocity, so the view has to skip the other half
+static void BM_ComponentManagerView(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ComponentManager manager;
+    for (Entity::ID entity = 0; entity < entities; ++entity) {
+        manager.addComponent<Transform>(entity, Transform(float(entity), 0.f, 0.f));
+        if (entity % 2 == 0) {
+            manager.addComponent<Velocity>(entity, Velocity(1.f, 1.f));
+        }
+    }
+
+    measureFrames(state, entities, [&] {
+        float sum = 0.f;
+        manager.forEach<Velocity, Transform>([&](Entity::ID, Velocity& velocity, Transform& transform) {
+            sum += velocity.dx * transform.x;
+        });
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+static void BM_ObjectPoolAcquireRelease(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ObjectPool pool(entities);
+    std::vector<Entity::ID> acquired;
+    acquired.reserve(entities);
+
+    measureFrames(state, entities,
+        [&] { acquired.clear(); },
+        [&] {
+            for (size_t i = 0; i < entities; ++i) {
+                acquired.push_back(pool.acquire()->getId());
+            }
+            for (Entity::ID entity : acquired) {
+                pool.release(entity);
+            }
+        });
+}
+
+// Fill a pool that starts with one small chunk, so every frame pays for the growth
+static void BM_ObjectPoolGrow(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    std::unique_ptr<ObjectPool> pool;
+
+    measureFrames(state, entities,
+        [&] { pool = std::make_unique<ObjectPool>(256); },
+        [&] {
+            for (size_t i = 0; i < entities; ++i) {
+                benchmark::DoNotOptimize(pool->acquire());
+            }
+        });
+}
+
+static void BM_MovementSystemUpdate(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    Arena arena{ 800.f, 800.f };
+    ComponentManager manager;
+    addProjectiles(manager, arena, 2, entities);
+    MovementSystem movementSystem;
+
+    measureFrames(state, entities, [&] { movementSystem.update(manager, 1.f / 60.f); });
+}
+
+// The movement kernel alone over row-aligned arrays, as one archetype chunk column after another
+// holds them. range(1) picks the build's vector path (1) or the scalar loop (0).
+static void BM_MovementKernel(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    bool vector = state.range(1) != 0;
+    std::vector<Velocity> velocities(entities, Velocity(60.f, -80.f));
+    std::vector<Transform> transforms(entities, Transform(400.f, 400.f, 0.f));
+    std::vector<BoxCollider> boxes(entities, BoxCollider(400.f, 400.f, 10.f, 10.f));
+
+    measureFrames(state, entities, [&] {
+        if (vector) {
+            MovementKernels::integrate(velocities.data(), transforms.data(), boxes.data(), entities, 1.f / 60.f);
+        }
+        else {
+            MovementKernels::integrateScalar(velocities.data(), transforms.data(), boxes.data(), 0, entities, 1.f / 60.f);
+        }
+        benchmark::ClobberMemory();
+    });
+    state.SetLabel(vector ? MovementKernels::instructionSet() : "scalar");
+}
+
+static void BM_SnapshotSystemUpdate(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    Arena arena{ 800.f, 800.f };
+    ComponentManager manager;
+    addProjectiles(manager, arena, 2, entities);
+    SnapshotSystem snapshotSystem;
+
+    measureFrames(state, entities, [&] { snapshotSystem.update(manager); });
+}
+
+static void BM_RotationSystemUpdate(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    ComponentManager manager;
+    for (Entity::ID entity = 0; entity < entities; ++entity) {
+        manager.addComponent<Transform>(entity, Transform(0.f, 0.f, 0.f));
+        manager.addComponent<Rotation>(entity, Rotation(float(entity % 360), 80.f, entity % 2 == 0, 390.f, 390.f, 200.f, 390.f, 110.f));
+    }
+    RotationSystem rotationSystem;
+
+    measureFrames(state, entities, [&] { rotationSystem.update(manager, 1.f / 60.f); });
+}
+
+// Not a timing: checks the incremental orbits against the direct trig formula RotationSystem
+// used to evaluate every tick. Runs ten minutes of ticks, reversing and speeding up orbiters
+// along the way, and reports the largest position error seen in max_error_px.
+static void BM_RotationSystemAccuracy(benchmark::State& state) {
+    size_t entities = 1000;
+    const float maxErrorAllowed = 0.01f;  // Pixels; well under what a frame can show
+
+    double maxError = 0.0;
+    for (auto _ : state) {
+        ComponentManager manager;
+        for (Entity::ID entity = 0; entity < entities; ++entity) {
+            manager.addComponent<Transform>(entity, Transform(0.f, 0.f, 0.f));
+            manager.addComponent<Rotation>(entity, Rotation(float(entity % 360), 80.f, entity % 2 == 0, 390.f, 390.f, 200.f + entity % 190, 390.f, 110.f));
+        }
+        RotationSystem rotationSystem;
+
+        for (int tick = 1; tick <= 36000; ++tick) {
+            if (tick % 1000 == 0) {
+                manager.forEach<Rotation>([&](Entity::ID entity, Rotation& rotation) {
+                    if (entity % 3 == 0) rotation.clockwise = !rotation.clockwise;
+                    if (entity % 5 == 0) rotation.speed += 50.f;
+                });
+            }
+            rotationSystem.update(manager, 1.f / 60.f);
+
+            if (tick % 7 != 0) continue;
+            manager.forEach<Rotation, Transform>([&](Entity::ID, Rotation& rotation, Transform& transform) {
+                double x = rotation.centerX + rotation.radius * std::cos(rotation.angle * M_PI / 180.f);
+                double y = rotation.centerY + rotation.radius * std::sin(rotation.angle * M_PI / 180.f);
+                maxError = std::max(maxError, std::hypot(transform.x - x, transform.y - y));
+            });
+        }
+    }
+
+    state.counters["max_error_px"] = maxError;
+    if (maxError > maxErrorAllowed) {
+        state.SkipWithError("Incremental rotation drifted from the trig path");
+    }
+}
+
+// The arena grows with the entity count so the projectile density stays the same
+static void BM_CollisionSystemUpdate(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    float side = 800.f * std::sqrt(entities / 1000.f);
+    Arena arena{ side, side };
+    ComponentManager manager;
+    addPlayerAndBase(manager, arena);
+    addProjectiles(manager, arena, 2, entities);
+    CollisionSystem collisionSystem;
+
+    // Nothing resolves the events, so every frame detects the same collisions
+    measureFrames(state, entities,
+        [&] { collisionSystem.getEvents().clear(); },
+        [&] { collisionSystem.update(manager); });
+}
+
+// Thread scaling of the parallel sweeps at 100k projectiles. range(0) is the total thread count,
+// the calling thread included, so threads=1 is the serial baseline.
+static void BM_MovementSystemParallel(benchmark::State& state) {
+    size_t entities = 100000;
+    Arena arena{ 800.f, 800.f };
+    ComponentManager manager;
+    addProjectiles(manager, arena, 2, entities);
+    JobScheduler scheduler(static_cast<unsigned int>(state.range(0) - 1));
+    MovementSystem movementSystem;
+    movementSystem.setScheduler(&scheduler);
+
+    measureFrames(state, entities, [&] { movementSystem.update(manager, 1.f / 60.f); });
+}
+
+// Only the BoxCollider sync is split, so the broadphase and narrowphase dilute the curve
+static void BM_CollisionSystemParallel(benchmark::State& state) {
+    size_t entities = 100000;
+    float side = 800.f * std::sqrt(entities / 1000.f);
+    Arena arena{ side, side };
+    ComponentManager manager;
+    addPlayerAndBase(manager, arena);
+    addProjectiles(manager, arena, 2, entities);
+    JobScheduler scheduler(static_cast<unsigned int>(state.range(0) - 1));
+    CollisionSystem collisionSystem;
+    collisionSystem.setScheduler(&scheduler);
+
+    measureFrames(state, entities,
+        [&] { collisionSystem.getEvents().clear(); },
+        [&] { collisionSystem.update(manager); });
+}
+
+// 1, 2, 4, ... threads up to the hardware thread count
+static void threadCounts(benchmark::internal::Benchmark* benchmark) {
+    int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < hardwareThreads; threads *= 2) {
+        benchmark->Arg(threads);
+    }
+    benchmark->Arg(hardwareThreads);
+}
+
+// Ten seconds of game time per update until a whole pool's worth of projectiles is out, so early
+// levels spawn two or three at a time and later ones spawn waves of hundreds
+static void BM_ProjectileSpawnSystemUpdate(benchmark::State& state) {
+    size_t entities = static_cast<size_t>(state.range(0));
+    Arena arena{ 800.f, 800.f };
+    ComponentManager manager;
+    ObjectPool projectilePool(entities);
+    Random random(1234);
+    ProjectileSpawnSystem projectileSpawnSystem(projectilePool, random, 4.f);
+    SilenceLog silence;
+
+    measureFrames(state, entities,
+        [&] { projectileSpawnSystem.reset(manager); },
+        [&] {
+            while (projectilePool.activeCount() < entities) {
+                projectileSpawnSystem.update(manager, arena, 10.f);
+            }
+        });
+}
+
+BENCHMARK(BM_ComponentManagerAdd)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_ComponentManagerGet)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_ComponentManagerRemove)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_ComponentManagerView)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_ObjectPoolAcquireRelease)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_ObjectPoolGrow)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_MovementSystemUpdate)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_MovementKernel)->ArgsProduct({ { 1000, 10000, 100000 }, { 0, 1 } })->ArgNames({ "entities", "vector" })->UseManualTime();
+BENCHMARK(BM_SnapshotSystemUpdate)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_RotationSystemUpdate)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_RotationSystemAccuracy)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CollisionSystemUpdate)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+BENCHMARK(BM_MovementSystemParallel)->Apply(threadCounts)->ArgName("threads")->UseManualTime();
+BENCHMARK(BM_CollisionSystemParallel)->Apply(threadCounts)->ArgName("threads")->UseManualTime();
+BENCHMARK(BM_ProjectileSpawnSystemUpdate)->RangeMultiplier(10)->Range(1000, 100000)->UseManualTime();
+
+BENCHMARK_MAIN();
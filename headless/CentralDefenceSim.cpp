@@ -0,0 +1,99 @@
+// Headless build of the game (central_defence_sim): steps the Simulation a fixed number of ticks
+// as fast as possible with no window and no rendering, then reports the tick rate and final state.
+// Used for balance sweeps and perf checks on machines without a display.
+//
+// Built by the central_defence_sim target in the top-level CMakeLists.txt, which logs at info level
+// so the per-spawn debug messages compile out.
+//
+// Usage: central_defence_sim [ticks] [arena width] [arena height] [worker threads] [trace file]
+//        central_defence_sim --replay input.log [worker threads]
+// With CENTRAL_DEFENCE_PROFILER defined, a trace file gets the last few thousand ticks' system
+// zones as Chrome trace_event JSON.
+//
+// --replay plays back a log from central_defence --record with its seed, arena and tick length.
+// The state hash printed at the end matches the one the game logged when the recording stopped.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../Commands.h"
+#include "../InputLog.h"
+#include "../Log.h"
+#include "../Profiler.h"
+#include "../Simulation.h"
+
+namespace {
+
+// Step a simulation built from the recording's header, feeding each tick the input it had
+int replay(const char* path, unsigned int workers) {
+    InputPlayback playback;
+    if (!playback.open(path)) {
+        std::fprintf(stderr, "can't read input log %s\n", path);
+        return 1;
+    }
+    const SessionHeader& header = playback.getHeader();
+    Simulation simulation(Arena{ header.arenaWidth, header.arenaHeight }, workers, header.seed);
+
+    long ticks = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (!playback.finished()) {
+        PlayerInput::execute(playback.next(), simulation.getComponentManager(), simulation.getPlayerEntity());
+        simulation.update(header.tickLength);
+        ++ticks;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Log::flush();
+
+    std::printf("replayed %ld ticks, seed %u, arena %.0fx%.0f, %u worker threads, %.3f s\n",
+        ticks, header.seed, header.arenaWidth, header.arenaHeight, simulation.getWorkerThreads(), seconds);
+    std::printf("state hash %llu\n", static_cast<unsigned long long>(simulation.stateHash()));
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0) {
+        return replay(argv[2], argc > 3 ? static_cast<unsigned int>(std::atoi(argv[3])) : JobScheduler::defaultWorkerCount());
+    }
+
+    const float tickLength = 1.f / 60.f;  // Same frame time the game targets
+
+    long ticks = argc > 1 ? std::atol(argv[1]) : 36000;  // Ten minutes of game time
+    Arena arena{ 800.f, 800.f };
+    if (argc > 2) arena.width = static_cast<float>(std::atof(argv[2]));
+    if (argc > 3) arena.height = static_cast<float>(std::atof(argv[3]));
+    unsigned int workers = argc > 4 ? static_cast<unsigned int>(std::atoi(argv[4])) : JobScheduler::defaultWorkerCount();
+
+    Simulation simulation(arena, workers);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long tick = 0; tick < ticks; ++tick) {
+        simulation.update(tickLength);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Log::flush();  // Get the run's messages out before the summary
+
+    if (argc > 5 && !Profiler::writeChromeTrace(argv[5])) {
+        std::fprintf(stderr, "no trace written to %s (profiler compiled out, or file not writable)\n", argv[5]);
+    }
+
+    // Final state, so balance sweeps can compare runs
+    ComponentManager& manager = simulation.getComponentManager();
+    size_t inFlight = 0;
+    for (auto [entity, velocity] : manager.view<Velocity>()) {
+        if (manager.isEntityInUse(entity)) ++inFlight;
+    }
+    Health* baseHealth = manager.getComponent<Health>(simulation.getBaseEntity());
+
+    std::printf("ticks %ld, arena %.0fx%.0f, %u worker threads, %.3f s, %.0f ticks/s\n",
+        ticks, arena.width, arena.height, simulation.getWorkerThreads(), seconds, ticks / seconds);
+    std::printf("in flight %zu, base health %d\n", inFlight, baseHealth ? baseHealth->currentHealth : 0);
+    std::printf("seed %u, state hash %llu\n", simulation.getSeed(), static_cast<unsigned long long>(simulation.stateHash()));
+
+    // Pool telemetry, for sizing the projectile pool's chunk and high-water mark
+    const ObjectPool& pool = simulation.getProjectilePool();
+    std::printf("projectile pool capacity %zu, peak %zu, grown %zu times, exhausted %zu times\n",
+        pool.capacity(), pool.getPeakActive(), pool.getGrowthCount(), pool.getExhaustionCount());
+    return 0;
+}
@@ -1,8 +1,20 @@
 #include "Game.h"
+#include <cstdlib>
+#include <cstring>
 
-int main() {
-    Game game;
+// central_defence [--seed N] [--record file]
+// --record logs every tick's input, so central_defence_sim --replay can repeat the session
+int main(int argc, char* argv[]) {
+    std::uint32_t seed = Game::randomSeed();
+    const char* recordPath = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--seed") == 0) seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        else if (std::strcmp(argv[i], "--record") == 0) recordPath = argv[i + 1];
+    }
+
+    Game game(60.f, seed);
+    if (recordPath) game.recordInput(recordPath);
     game.run();
 
     return 0;
-}
\ No newline at end of file
+}